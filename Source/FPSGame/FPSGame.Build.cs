@@ -1,5 +1,6 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
+using System.IO;
 using UnrealBuildTool;
 
 public class FPSGame : ModuleRules
@@ -9,7 +10,15 @@ public class FPSGame : ModuleRules
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
 		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "AIModule",
-			"Learning", "LearningAgents", "LearningTraining", "LearningAgentsTraining"
+			"Learning", "LearningAgents", "LearningTraining", "LearningAgentsTraining", "ReplicationGraph"
+		});
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Json" });
+
+		// Learning and Testing sources include each other's headers
+		PrivateIncludePaths.AddRange(new string[] {
+			Path.Combine(ModuleDirectory, "Learning"),
+			Path.Combine(ModuleDirectory, "Testing")
 		});
 	}
 }
@@ -0,0 +1,127 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSAgentPool.h"
+#include "FPSCharacter.h"
+#include "AIController.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+AFPSCharacter* FFPSAgentPool::Acquire(UWorld* World, TSubclassOf<AFPSCharacter> CharacterClass, TSubclassOf<AController> ControllerClass,
+	const FTransform& Transform, AActor* Owner)
+{
+	for (int32 Index = 0; Index < Characters.Num(); Index++)
+	{
+		AFPSCharacter* Character = Characters[Index];
+		if (!Active[Index] && IsValid(Character) && Character->IsA(CharacterClass))
+		{
+			Character->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+			Character->SetOwner(Owner);
+			SetAgentActive(Character, true);
+			Active[Index] = true;
+			return Character;
+		}
+	}
+
+	if (!World || !CharacterClass)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = Owner;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	AFPSCharacter* Character = World->SpawnActor<AFPSCharacter>(CharacterClass, Transform, SpawnParams);
+	if (!Character)
+	{
+		return nullptr;
+	}
+
+	AController* Controller = Character->GetController();
+	if (!Controller)
+	{
+		Controller = World->SpawnActor<AController>(ControllerClass ? *ControllerClass : AAIController::StaticClass());
+		if (Controller)
+		{
+			Controller->Possess(Character);
+		}
+	}
+
+	Characters.Add(Character);
+	Controllers.Add(Controller);
+	Active.Add(true);
+	return Character;
+}
+
+void FFPSAgentPool::Release(AFPSCharacter* Character)
+{
+	const int32 Index = Characters.Find(Character);
+	if (Index != INDEX_NONE && Active[Index])
+	{
+		SetAgentActive(Character, false);
+		Active[Index] = false;
+	}
+}
+
+void FFPSAgentPool::ReleaseAll()
+{
+	for (int32 Index = 0; Index < Characters.Num(); Index++)
+	{
+		if (Active[Index] && IsValid(Characters[Index]))
+		{
+			SetAgentActive(Characters[Index], false);
+		}
+		Active[Index] = false;
+	}
+}
+
+void FFPSAgentPool::Empty()
+{
+	for (AController* Controller : Controllers)
+	{
+		if (IsValid(Controller))
+		{
+			Controller->Destroy();
+		}
+	}
+	for (AFPSCharacter* Character : Characters)
+	{
+		if (IsValid(Character))
+		{
+			Character->Destroy();
+		}
+	}
+
+	Characters.Reset();
+	Controllers.Reset();
+	Active.Reset();
+}
+
+void FFPSAgentPool::GetActive(TArray<AFPSCharacter*>& OutCharacters) const
+{
+	for (int32 Index = 0; Index < Characters.Num(); Index++)
+	{
+		if (Active[Index] && IsValid(Characters[Index]))
+		{
+			OutCharacters.Add(Characters[Index]);
+		}
+	}
+}
+
+int32 FFPSAgentPool::GetActiveNum() const
+{
+	return Active.CountSetBits();
+}
+
+void FFPSAgentPool::SetAgentActive(AFPSCharacter* Character, bool bActive)
+{
+	Character->SetActorHiddenInGame(!bActive);
+	Character->SetActorEnableCollision(bActive);
+	Character->SetActorTickEnabled(bActive);
+
+	if (UCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement())
+	{
+		MovementComponent->StopMovementImmediately();
+		MovementComponent->SetComponentTickEnabled(bActive);
+	}
+}
@@ -0,0 +1,44 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FPSAgentPool.generated.h"
+
+class AFPSCharacter;
+class AController;
+
+/**
+ * Spawned agent pawns and their controllers. Released agents are hidden and parked instead of destroyed, and
+ * handed out again by Acquire before anything new is spawned.
+ */
+USTRUCT()
+struct FPSGAME_API FFPSAgentPool
+{
+	GENERATED_BODY()
+
+	// Reuses a parked agent or spawns a new pawn and controller, placed at Transform and owned by Owner
+	AFPSCharacter* Acquire(UWorld* World, TSubclassOf<AFPSCharacter> CharacterClass, TSubclassOf<AController> ControllerClass,
+		const FTransform& Transform, AActor* Owner);
+
+	void Release(AFPSCharacter* Character);
+	void ReleaseAll();
+
+	// Destroys everything, active or not
+	void Empty();
+
+	void GetActive(TArray<AFPSCharacter*>& OutCharacters) const;
+	int32 GetActiveNum() const;
+	int32 GetPooledNum() const { return Characters.Num() - GetActiveNum(); }
+
+private:
+	static void SetAgentActive(AFPSCharacter* Character, bool bActive);
+
+	UPROPERTY()
+	TArray<AFPSCharacter*> Characters;
+
+	UPROPERTY()
+	TArray<AController*> Controllers;
+
+	TBitArray<> Active;
+};
@@ -7,6 +7,9 @@
 #include "FPSTargetActor.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "FPSCharacter.h"
+#include "FPSLearningLog.h"
+#include "FPSCharacterManager.h"
+#include "FPSSceneQueries.h"
 
 UFPSCharacterInteractor::UFPSCharacterInteractor()
 {
@@ -50,10 +53,127 @@ void UFPSCharacterInteractor::SpecifyAgentObservation_Implementation(
 	CharacterObservations.Add("FacingAlignment", 
 		ULearningAgentsObservations::SpecifyFloatObservation(InObservationSchema, 1.0f));
 
+	if (const AFPSCharacterManager* CharacterManager = Cast<AFPSCharacterManager>(Manager->GetOwner()))
+	{
+		RayFanSettings = CharacterManager->RayFanSettings;
+		NeighborSettings = CharacterManager->NeighborSettings;
+	}
+
+	// Normalized hit distance per ray
+	if (RayFanSettings.bEnabled)
+	{
+		CharacterObservations.Add("RayFan",
+			ULearningAgentsObservations::SpecifyStaticArrayObservation(InObservationSchema,
+				ULearningAgentsObservations::SpecifyFloatObservation(InObservationSchema, 1.0f), RayFanSettings.GetRayNum()));
+	}
+
+	// Nearest agents relative to this one, Valid is 0 for unused slots
+	if (NeighborSettings.NeighborNum > 0)
+	{
+		TMap<FName, FLearningAgentsObservationSchemaElement> NeighborObservation;
+		NeighborObservation.Add("Location",
+			ULearningAgentsObservations::SpecifyLocationObservation(InObservationSchema, NeighborSettings.MaxDistance, "LocationObservation"));
+		NeighborObservation.Add("Velocity",
+			ULearningAgentsObservations::SpecifyVelocityObservation(InObservationSchema, MaxVelocity));
+		NeighborObservation.Add("Valid",
+			ULearningAgentsObservations::SpecifyFloatObservation(InObservationSchema, 1.0f));
+
+		CharacterObservations.Add("Neighbors",
+			ULearningAgentsObservations::SpecifyStaticArrayObservation(InObservationSchema,
+				ULearningAgentsObservations::SpecifyStructObservation(InObservationSchema, NeighborObservation), NeighborSettings.NeighborNum));
+	}
+
 	// Set the complete observation schema
 	OutObservationSchemaElement = ULearningAgentsObservations::SpecifyStructObservation(InObservationSchema, CharacterObservations);
 }
 
+void UFPSCharacterInteractor::GatherAgentObservations_Implementation(
+	TArray<FLearningAgentsObservationObjectElement>& OutObservationObjectElements,
+	ULearningAgentsObservationObject* InObservationObject, const TArray<int32>& AgentIds)
+{
+	// Collect last step's ray results and issue this step's traces for all agents in one pass
+	if (RayFanSettings.bEnabled)
+	{
+		if (!RayFanSensor.IsInitialized())
+		{
+			RayFanSensor.Initialize(RayFanSettings, Manager->GetMaxAgentNum());
+		}
+
+		RayFanSensor.Update(GetWorld(), AgentIds, [this](int32 AgentId)
+		{
+			return Cast<AActor>(Manager->GetAgent(AgentId, AFPSCharacter::StaticClass()));
+		});
+	}
+
+	if (NeighborSettings.NeighborNum > 0)
+	{
+		UpdateNeighbors(AgentIds);
+	}
+
+	// Elements in the observation object can be referenced by any number of agent observations, so shared
+	// segments are encoded once here instead of once per agent
+	SharedSegments.Reset();
+	SharedSegmentsObject = nullptr;
+	if (bShareObservationSegments)
+	{
+		GatherSharedObservationSegments(SharedSegments, InObservationObject);
+		SharedSegmentsObject = InObservationObject;
+	}
+
+	Super::GatherAgentObservations_Implementation(OutObservationObjectElements, InObservationObject, AgentIds);
+
+	SharedSegmentsObject = nullptr;
+}
+
+void UFPSCharacterInteractor::GatherSharedObservationSegments(TMap<FName, FLearningAgentsObservationObjectElement>& OutSegments,
+	ULearningAgentsObservationObject* InObservationObject)
+{
+	if (TargetActor)
+	{
+		OutSegments.Add("TargetLocation",
+			ULearningAgentsObservations::MakeLocationObservation(InObservationObject, TargetActor->GetActorLocation()));
+	}
+}
+
+const FLearningAgentsObservationObjectElement* UFPSCharacterInteractor::FindSharedSegment(FName Name, const ULearningAgentsObservationObject* InObservationObject) const
+{
+	return InObservationObject == SharedSegmentsObject ? SharedSegments.Find(Name) : nullptr;
+}
+
+void UFPSCharacterInteractor::UpdateNeighbors(const TArray<int32>& AgentIds)
+{
+	const int32 NeighborNum = NeighborSettings.NeighborNum;
+
+	NeighborPositions.Reset(AgentIds.Num());
+	NeighborVelocities.Reset(AgentIds.Num());
+	AgentNeighborRows.Init(INDEX_NONE, Manager->GetMaxAgentNum());
+
+	for (const int32 AgentId : AgentIds)
+	{
+		const AFPSCharacter* Character = Cast<AFPSCharacter>(Manager->GetAgent(AgentId, AFPSCharacter::StaticClass()));
+		if (!Character || !AgentNeighborRows.IsValidIndex(AgentId))
+		{
+			continue;
+		}
+
+		AgentNeighborRows[AgentId] = NeighborPositions.Num();
+		NeighborPositions.Add(Character->GetActorLocation());
+		NeighborVelocities.Add(Character->GetVelocity());
+	}
+
+	NeighborHash.Build(NeighborPositions, NeighborSettings.CellSize);
+
+	const int32 RowNum = NeighborPositions.Num();
+	NeighborCounts.SetNumUninitialized(RowNum);
+	Neighbors.SetNumUninitialized(RowNum * NeighborNum);
+
+	FPSSceneQueries::ParallelBatch(RowNum, [this, NeighborNum](int32 Row)
+	{
+		NeighborCounts[Row] = NeighborHash.FindNearest(NeighborPositions[Row], Row, NeighborSettings.MaxDistance,
+			TArrayView<int32>(Neighbors.GetData() + Row * NeighborNum, NeighborNum));
+	});
+}
+
 void UFPSCharacterInteractor::GatherAgentObservation_Implementation(
 	FLearningAgentsObservationObjectElement& OutObservationObjectElement,
 	ULearningAgentsObservationObject* InObservationObject, const int32 AgentId)
@@ -65,11 +185,11 @@ void UFPSCharacterInteractor::GatherAgentObservation_Implementation(
 	{
 		if (!Character)
 		{
-			UE_LOG(LogTemp, Error, TEXT("FPSCharacterInteractor: Failed to get character for agent %d"), AgentId);
+			FPS_LEARNING_LOG(Observation, Error, TEXT("FPSCharacterInteractor: Failed to get character for agent %d"), AgentId);
 		}
 		if (!TargetActor)
 		{
-			UE_LOG(LogTemp, Error, TEXT("FPSCharacterInteractor: TargetActor is NULL - make sure FPSCharacterManager.TargetActor is set!"));
+			FPS_LEARNING_LOG(Observation, Error, TEXT("FPSCharacterInteractor: TargetActor is NULL - make sure FPSCharacterManager.TargetActor is set!"));
 		}
 		return;
 	}
@@ -94,9 +214,11 @@ void UFPSCharacterInteractor::GatherAgentObservation_Implementation(
 	CharacterObservationObject.Add("CharacterDirection", 
 		ULearningAgentsObservations::MakeDirectionObservation(InObservationObject, Character->GetActorForwardVector()));
 
-	// Target location
-	CharacterObservationObject.Add("TargetLocation", 
-		ULearningAgentsObservations::MakeLocationObservation(InObservationObject, TargetActor->GetActorLocation()));
+	// Target location, shared between agents when it was gathered for this step
+	const FLearningAgentsObservationObjectElement* SharedTargetLocation = FindSharedSegment("TargetLocation", InObservationObject);
+	CharacterObservationObject.Add("TargetLocation", SharedTargetLocation
+		? *SharedTargetLocation
+		: ULearningAgentsObservations::MakeLocationObservation(InObservationObject, TargetActor->GetActorLocation()));
 
 	// Direction from character to target
 	FVector DirectionToTarget = (TargetActor->GetActorLocation() - Character->GetActorLocation()).GetSafeNormal();
@@ -114,6 +236,48 @@ void UFPSCharacterInteractor::GatherAgentObservation_Implementation(
 	CharacterObservationObject.Add("FacingAlignment", 
 		ULearningAgentsObservations::MakeFloatObservation(InObservationObject, FacingAlignment));
 
+	if (RayFanSettings.bEnabled)
+	{
+		const TConstArrayView<float> RayDistances = RayFanSensor.GetDistances(AgentId);
+
+		TArray<FLearningAgentsObservationObjectElement> RayObservations;
+		RayObservations.Reserve(RayFanSettings.GetRayNum());
+		for (int32 RayIdx = 0; RayIdx < RayFanSettings.GetRayNum(); RayIdx++)
+		{
+			RayObservations.Add(ULearningAgentsObservations::MakeFloatObservation(InObservationObject,
+				RayDistances.IsValidIndex(RayIdx) ? RayDistances[RayIdx] : 1.0f));
+		}
+		CharacterObservationObject.Add("RayFan",
+			ULearningAgentsObservations::MakeStaticArrayObservation(InObservationObject, RayObservations));
+	}
+
+	if (NeighborSettings.NeighborNum > 0)
+	{
+		const FTransform AgentTransform = Character->GetActorTransform();
+		const int32 Row = AgentNeighborRows.IsValidIndex(AgentId) ? AgentNeighborRows[AgentId] : INDEX_NONE;
+		const int32 FoundNum = Row != INDEX_NONE ? NeighborCounts[Row] : 0;
+
+		TArray<FLearningAgentsObservationObjectElement> NeighborObservations;
+		NeighborObservations.Reserve(NeighborSettings.NeighborNum);
+		for (int32 NeighborIdx = 0; NeighborIdx < NeighborSettings.NeighborNum; NeighborIdx++)
+		{
+			const bool bValid = NeighborIdx < FoundNum;
+			const int32 Other = bValid ? Neighbors[Row * NeighborSettings.NeighborNum + NeighborIdx] : INDEX_NONE;
+
+			TMap<FName, FLearningAgentsObservationObjectElement> NeighborObservation;
+			NeighborObservation.Add("Location", ULearningAgentsObservations::MakeLocationObservation(InObservationObject,
+				bValid ? NeighborPositions[Other] : Character->GetActorLocation(), AgentTransform));
+			NeighborObservation.Add("Velocity", ULearningAgentsObservations::MakeVelocityObservation(InObservationObject,
+				bValid ? NeighborVelocities[Other] : FVector::ZeroVector, AgentTransform));
+			NeighborObservation.Add("Valid", ULearningAgentsObservations::MakeFloatObservation(InObservationObject,
+				bValid ? 1.0f : 0.0f));
+
+			NeighborObservations.Add(ULearningAgentsObservations::MakeStructObservation(InObservationObject, NeighborObservation));
+		}
+		CharacterObservationObject.Add("Neighbors",
+			ULearningAgentsObservations::MakeStaticArrayObservation(InObservationObject, NeighborObservations));
+	}
+
 	// Set the complete observation object
 	OutObservationObjectElement = ULearningAgentsObservations::MakeStructObservation(InObservationObject, CharacterObservationObject);
 }
@@ -145,6 +309,55 @@ void UFPSCharacterInteractor::SpecifyAgentAction_Implementation(
 	OutActionSchemaElement = ULearningAgentsActions::SpecifyStructAction(InActionSchema, CharacterActions);
 }
 
+void UFPSCharacterInteractor::PerformAgentActions_Implementation(
+	const ULearningAgentsActionObject* InActionObject,
+	const TArray<FLearningAgentsActionObjectElement>& InActionObjectElements,
+	const TArray<int32>& AgentIds)
+{
+	const int32 AgentNum = AgentIds.Num();
+	AgentCommands.SetNum(AgentNum);
+	AgentForwardVectors.SetNum(AgentNum);
+	AgentRightVectors.SetNum(AgentNum);
+
+	// Game thread: resolve characters, capture their facing and read the action values
+	for (int32 Index = 0; Index < AgentNum; Index++)
+	{
+		FFPSAgentCommand& Command = AgentCommands[Index];
+		Command = FFPSAgentCommand();
+		Command.Character = Cast<AFPSCharacter>(Manager->GetAgent(AgentIds[Index], AFPSCharacter::StaticClass()));
+		if (!Command.Character)
+		{
+			FPS_LEARNING_LOG(Action, Error, TEXT("FPSCharacterInteractor: Failed to get character for agent %d in PerformAgentActions"), AgentIds[Index]);
+			continue;
+		}
+
+		if (!ReadAgentAction(InActionObject, InActionObjectElements[Index], AgentIds[Index], Command.Actions))
+		{
+			Command.Character = nullptr;
+			continue;
+		}
+
+		AgentForwardVectors[Index] = Command.Character->GetActorForwardVector();
+		AgentRightVectors[Index] = Command.Character->GetActorRightVector();
+	}
+
+	// Workers: turn the values into the command buffer
+	FPSSceneQueries::ParallelBatch(AgentNum, [this](int32 Index)
+	{
+		FFPSAgentCommand& Command = AgentCommands[Index];
+		if (Command.Character)
+		{
+			BuildAgentCommand(Command.Actions, AgentForwardVectors[Index], AgentRightVectors[Index], Command);
+		}
+	});
+
+	// Game thread: one pass of engine calls
+	for (int32 Index = 0; Index < AgentNum; Index++)
+	{
+		ApplyAgentCommand(AgentIds[Index], AgentCommands[Index]);
+	}
+}
+
 void UFPSCharacterInteractor::PerformAgentAction_Implementation(
 	const ULearningAgentsActionObject* InActionObject,
 	const FLearningAgentsActionObjectElement& InActionObjectElement,
@@ -155,16 +368,28 @@ void UFPSCharacterInteractor::PerformAgentAction_Implementation(
 	
 	if (!Character)
 	{
-		UE_LOG(LogTemp, Error, TEXT("FPSCharacterInteractor: Failed to get character for agent %d in PerformAgentAction"), AgentId);
+		FPS_LEARNING_LOG(Action, Error, TEXT("FPSCharacterInteractor: Failed to get character for agent %d in PerformAgentAction"), AgentId);
 		return;
 	}
 
+	FFPSAgentCommand Command;
+	Command.Character = Character;
+	if (ReadAgentAction(InActionObject, InActionObjectElement, AgentId, Command.Actions))
+	{
+		BuildAgentCommand(Command.Actions, Character->GetActorForwardVector(), Character->GetActorRightVector(), Command);
+		ApplyAgentCommand(AgentId, Command);
+	}
+}
+
+bool UFPSCharacterInteractor::ReadAgentAction(const ULearningAgentsActionObject* InActionObject,
+	const FLearningAgentsActionObjectElement& InActionObjectElement, const int32 AgentId, FVector4f& OutActions) const
+{
 	// Extract actions from the action object
 	TMap<FName, FLearningAgentsActionObjectElement> CharacterActionObjects;
 	if (!ULearningAgentsActions::GetStructAction(CharacterActionObjects, InActionObject, InActionObjectElement))
 	{
-		UE_LOG(LogTemp, Error, TEXT("FPSCharacterInteractor: Failed to get struct action for agent %d"), AgentId);
-		return;
+		FPS_LEARNING_LOG(Action, Error, TEXT("FPSCharacterInteractor: Failed to get struct action for agent %d"), AgentId);
+		return false;
 	}
 
 	// Get movement actions
@@ -176,63 +401,92 @@ void UFPSCharacterInteractor::PerformAgentAction_Implementation(
 	const FLearningAgentsActionObjectElement* MoveForwardAction = CharacterActionObjects.Find("MoveForward");
 	if (MoveForwardAction && !ULearningAgentsActions::GetFloatAction(MoveForwardValue, InActionObject, *MoveForwardAction))
 	{
-		UE_LOG(LogTemp, Error, TEXT("FPSCharacterInteractor: Failed to get MoveForward action for agent %d"), AgentId);
+		FPS_LEARNING_LOG(Action, Error, TEXT("FPSCharacterInteractor: Failed to get MoveForward action for agent %d"), AgentId);
 	}
 
 	const FLearningAgentsActionObjectElement* MoveRightAction = CharacterActionObjects.Find("MoveRight");
 	if (MoveRightAction && !ULearningAgentsActions::GetFloatAction(MoveRightValue, InActionObject, *MoveRightAction))
 	{
-		UE_LOG(LogTemp, Error, TEXT("FPSCharacterInteractor: Failed to get MoveRight action for agent %d"), AgentId);
+		FPS_LEARNING_LOG(Action, Error, TEXT("FPSCharacterInteractor: Failed to get MoveRight action for agent %d"), AgentId);
 	}
 
 	const FLearningAgentsActionObjectElement* TurnAction = CharacterActionObjects.Find("Turn");
 	if (TurnAction && !ULearningAgentsActions::GetFloatAction(TurnValue, InActionObject, *TurnAction))
 	{
-		UE_LOG(LogTemp, Error, TEXT("FPSCharacterInteractor: Failed to get Turn action for agent %d"), AgentId);
+		FPS_LEARNING_LOG(Action, Error, TEXT("FPSCharacterInteractor: Failed to get Turn action for agent %d"), AgentId);
 	}
 
 	const FLearningAgentsActionObjectElement* LookUpAction = CharacterActionObjects.Find("LookUp");
 	if (LookUpAction && !ULearningAgentsActions::GetFloatAction(LookUpValue, InActionObject, *LookUpAction))
 	{
-		UE_LOG(LogTemp, Error, TEXT("FPSCharacterInteractor: Failed to get LookUp action for agent %d"), AgentId);
+		FPS_LEARNING_LOG(Action, Error, TEXT("FPSCharacterInteractor: Failed to get LookUp action for agent %d"), AgentId);
+	}
+
+	// Action values are rate limited by the Action channel budget
+	FPS_LEARNING_LOG(Action, Verbose, TEXT("Agent %d action: Forward=%.3f, Right=%.3f, Turn=%.3f, LookUp=%.3f"), 
+		AgentId, MoveForwardValue, MoveRightValue, TurnValue, LookUpValue);
+
+	OutActions = FVector4f(MoveForwardValue, MoveRightValue, TurnValue, LookUpValue);
+	return true;
+}
+
+void UFPSCharacterInteractor::BuildAgentCommand(const FVector4f& Actions, const FVector& ForwardVector, const FVector& RightVector, FFPSAgentCommand& OutCommand)
+{
+	const float MoveForwardValue = Actions.X;
+	const float MoveRightValue = Actions.Y;
+	const float TurnValue = Actions.Z;
+	const float LookUpValue = Actions.W;
+
+	OutCommand.Actions = Actions;
+
+	// Forward/backward and left/right movement combine into one input vector
+	FVector Movement = FVector::ZeroVector;
+	if (FMath::Abs(MoveForwardValue) > 0.01f)
+	{
+		Movement += ForwardVector * MoveForwardValue;
+	}
+	if (FMath::Abs(MoveRightValue) > 0.01f)
+	{
+		Movement += RightVector * MoveRightValue;
 	}
+	OutCommand.Movement = Movement;
+
+	// Rotation (yaw) with increased sensitivity for better target facing
+	const float TurnScale = 2.0f;
+	OutCommand.YawInput = FMath::Abs(TurnValue) > 0.01f ? TurnValue * TurnScale : 0.0f;
 
-	// DEBUG: Log action values for each agent
-	static int32 LogCounter = 0;
-	LogCounter++;
-	if (LogCounter % 60 == 0) // Log every 60 calls (roughly every second at 60fps)
+	// Pitch rotation for looking up/down
+	const float LookUpScale = 1.0f;
+	OutCommand.PitchInput = FMath::Abs(LookUpValue) > 0.01f ? LookUpValue * LookUpScale : 0.0f;
+}
+
+void UFPSCharacterInteractor::ApplyAgentCommand(const int32 AgentId, const FFPSAgentCommand& Command)
+{
+	AFPSCharacter* Character = Command.Character;
+	if (!Character)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("AGENT %d ACTION: Forward=%.3f, Right=%.3f, Turn=%.3f, LookUp=%.3f"), 
-			AgentId, MoveForwardValue, MoveRightValue, TurnValue, LookUpValue);
+		return;
 	}
 
-	// Apply movement actions to the character
-	if (Character)
+	if (LastActions.Num() <= AgentId)
 	{
-		// Apply forward/backward movement using AddMovementInput
-		if (FMath::Abs(MoveForwardValue) > 0.01f)
-		{
-			Character->AddMovementInput(Character->GetActorForwardVector(), MoveForwardValue);
-		}
-		
-		// Apply left/right movement using AddMovementInput
-		if (FMath::Abs(MoveRightValue) > 0.01f)
-		{
-			Character->AddMovementInput(Character->GetActorRightVector(), MoveRightValue);
-		}
-		
-		// Apply rotation (yaw) with increased sensitivity for better target facing
-		if (FMath::Abs(TurnValue) > 0.01f)
-		{
-			float TurnScale = 2.0f; // Increase rotation sensitivity
-			Character->AddControllerYawInput(TurnValue * TurnScale);
-		}
+		LastActions.SetNumZeroed(FMath::Max(AgentId + 1, Manager->GetMaxAgentNum()));
+	}
+	LastActions[AgentId] = Command.Actions;
 
-		// Apply pitch rotation for looking up/down
-		if (FMath::Abs(LookUpValue) > 0.01f)
-		{
-			float LookUpScale = 1.0f;
-			Character->AddControllerPitchInput(LookUpValue * LookUpScale);
-		}
+	// Same accumulated input as separate forward and right AddMovementInput calls
+	if (!Command.Movement.IsZero())
+	{
+		Character->AddMovementInput(Command.Movement, 1.0f);
 	}
-} 
\ No newline at end of file
+
+	if (Command.YawInput != 0.0f)
+	{
+		Character->AddControllerYawInput(Command.YawInput);
+	}
+
+	if (Command.PitchInput != 0.0f)
+	{
+		Character->AddControllerPitchInput(Command.PitchInput);
+	}
+}
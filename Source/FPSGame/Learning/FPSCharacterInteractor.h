@@ -4,9 +4,23 @@
 
 #include "CoreMinimal.h"
 #include "LearningAgentsInteractor.h"
+#include "FPSRayFanSensor.h"
+#include "FPSSpatialHash.h"
 #include "FPSCharacterInteractor.generated.h"
 
 class AFPSTargetActor;
+class AFPSCharacter;
+
+// Decoded action for one agent, applied to the character on the game thread
+struct FFPSAgentCommand
+{
+	AFPSCharacter* Character = nullptr;
+	FVector Movement = FVector::ZeroVector;
+	float YawInput = 0.0f;
+	float PitchInput = 0.0f;
+	// Raw MoveForward, MoveRight, Turn, LookUp values
+	FVector4f Actions = FVector4f(0.0f, 0.0f, 0.0f, 0.0f);
+};
 
 /**
  * Interactor for FPSCharacter learning agents
@@ -23,6 +37,11 @@ public:
 		FLearningAgentsObservationSchemaElement& OutObservationSchemaElement,
 		ULearningAgentsObservationSchema* InObservationSchema) override;
 
+	virtual void GatherAgentObservations_Implementation(
+		TArray<FLearningAgentsObservationObjectElement>& OutObservationObjectElements,
+		ULearningAgentsObservationObject* InObservationObject,
+		const TArray<int32>& AgentIds) override;
+
 	virtual void GatherAgentObservation_Implementation(
 		FLearningAgentsObservationObjectElement& OutObservationObjectElement,
 		ULearningAgentsObservationObject* InObservationObject,
@@ -32,6 +51,11 @@ public:
 		FLearningAgentsActionSchemaElement& OutActionSchemaElement,
 		ULearningAgentsActionSchema* InActionSchema) override;
 
+	virtual void PerformAgentActions_Implementation(
+		const ULearningAgentsActionObject* InActionObject,
+		const TArray<FLearningAgentsActionObjectElement>& InActionObjectElements,
+		const TArray<int32>& AgentIds) override;
+
 	virtual void PerformAgentAction_Implementation(
 		const ULearningAgentsActionObject* InActionObject,
 		const FLearningAgentsActionObjectElement& InActionObjectElement,
@@ -47,4 +71,71 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations")
 	float MaxVelocity = 1000.0f;
+
+	// Obstacle sensing. Taken from the owning AFPSCharacterManager when the observation schema is specified
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations")
+	FFPSRayFanSettings RayFanSettings;
+
+	// Build observation parts that are the same for every agent (like the target location) once per step and reuse them
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations")
+	bool bShareObservationSegments = true;
+
+	// Nearest other agents. Taken from the owning AFPSCharacterManager like RayFanSettings
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Observations")
+	FFPSNeighborSettings NeighborSettings;
+
+	// Raw action values last applied to the agent (MoveForward, MoveRight, Turn, LookUp)
+	FVector4f GetLastAction(const int32 AgentId) const { return LastActions.IsValidIndex(AgentId) ? LastActions[AgentId] : FVector4f(0.0f, 0.0f, 0.0f, 0.0f); }
+
+protected:
+	/**
+	 * Adds the observation elements shared by all agents this step to OutSegments. Subclasses can extend this with
+	 * further global features; per-agent gathering looks them up by name with FindSharedSegment.
+	 */
+	virtual void GatherSharedObservationSegments(TMap<FName, FLearningAgentsObservationObjectElement>& OutSegments,
+		ULearningAgentsObservationObject* InObservationObject);
+
+	const FLearningAgentsObservationObjectElement* FindSharedSegment(FName Name, const ULearningAgentsObservationObject* InObservationObject) const;
+
+private:
+	/**
+	 * Reads an agent's MoveForward, MoveRight, Turn and LookUp values out of the action object. Game thread only:
+	 * nothing guarantees ULearningAgentsActions is safe to call from workers.
+	 */
+	bool ReadAgentAction(const ULearningAgentsActionObject* InActionObject,
+		const FLearningAgentsActionObjectElement& InActionObjectElement, const int32 AgentId, FVector4f& OutActions) const;
+
+	/** Turns read action values into a command, given the character's facing. Pure math, safe on worker threads */
+	static void BuildAgentCommand(const FVector4f& Actions, const FVector& ForwardVector, const FVector& RightVector, FFPSAgentCommand& OutCommand);
+
+	void ApplyAgentCommand(const int32 AgentId, const FFPSAgentCommand& Command);
+
+	// Indexed by AgentId
+	TArray<FVector4f> LastActions;
+
+	// One entry per agent in the current PerformAgentActions batch
+	TArray<FFPSAgentCommand> AgentCommands;
+	TArray<FVector> AgentForwardVectors;
+	TArray<FVector> AgentRightVectors;
+
+	// Valid only inside GatherAgentObservations for SharedSegmentsObject
+	TMap<FName, FLearningAgentsObservationObjectElement> SharedSegments;
+	const ULearningAgentsObservationObject* SharedSegmentsObject = nullptr;
+
+	// Rebuilds the spatial hash from the agents' positions and finds every agent's neighbours in parallel
+	void UpdateNeighbors(const TArray<int32>& AgentIds);
+
+	FFPSRayFanSensor RayFanSensor;
+
+	FFPSSpatialHash NeighborHash;
+
+	// Per-step agent data, indexed by row in the spatial hash
+	TArray<FVector> NeighborPositions;
+	TArray<FVector> NeighborVelocities;
+	TArray<int32> NeighborCounts;
+	// NeighborNum entries per row
+	TArray<int32> Neighbors;
+
+	// Hash row for each AgentId, INDEX_NONE for agents not gathered this step
+	TArray<int32> AgentNeighborRows;
 }; 
\ No newline at end of file
@@ -5,15 +5,40 @@
 #include "FPSCharacterInteractor.h"
 #include "FPSCharacterTrainingEnvironment.h"
 #include "FPSTargetActor.h"
+#include "FPSLearningLog.h"
+#include "FPSTrainerProcessSubsystem.h"
+#include "FPSSignificanceSubsystem.h"
 #include "LearningAgentsPPOTrainer.h"
 #include "LearningAgentsCommunicator.h"
-#include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
+#include "GameFramework/Volume.h"
 #include "FPSCharacter.h"
 #include "Engine/Engine.h"
 #include "AIController.h"
 #include "LearningAgentsController.h"
 #include "LearningAgentsEntitiesManagerComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "HAL/FileManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommandWithWorldAndArgs SetAgentNumCommand(
+	TEXT("FPS.Agents.SetNum"),
+	TEXT("FPS.Agents.SetNum <count>: changes the number of agents of every manager spawning its own agents"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 AgentNum = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 0;
+		for (TActorIterator<AFPSCharacterManager> It(World); It; ++It)
+		{
+			It->SetSpawnedAgentNum(AgentNum);
+		}
+	}));
 
 AFPSCharacterManager::AFPSCharacterManager()
 {
@@ -23,67 +48,278 @@ AFPSCharacterManager::AFPSCharacterManager()
 	TrainingSettings.bSaveSnapshots = true;
 
 	LearningAgentsManager = CreateDefaultSubobject<UFPSCharacterManagerComponent>(TEXT("Learning Agents Manager"));
+
+	AgentClass = AFPSCharacter::StaticClass();
+	AgentControllerClass = AAIController::StaticClass();
+}
+
+void AFPSCharacterManager::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Start the trainer now so it boots while the rest of the level loads
+	UWorld* World = GetWorld();
+	if (World && World->IsGameWorld() && RunMode != EFPSCharacterManagerMode::Inference && GEngine)
+	{
+		bKeepTrainerAlive |= FParse::Param(FCommandLine::Get(), TEXT("FPSKeepTrainer"));
+		if (bKeepTrainerAlive && !bTrainerLoopsSessions)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s: Keeping the trainer alive needs a trainer that loops sessions (bTrainerLoopsSessions), it will be shut down with the manager"), *GetName());
+			bKeepTrainerAlive = false;
+		}
+		TrainerHandle = GEngine->GetEngineSubsystem<UFPSTrainerProcessSubsystem>()->RequestTrainer(TrainerProcessSettings, SharedMemorySettings);
+	}
 }
 
 void AFPSCharacterManager::BeginPlay()
 {
 	Super::BeginPlay();
+
+	FParse::Value(FCommandLine::Get(), TEXT("FPSSpawnAgents="), SpawnAgentCount);
+	bRecordEpisodes |= FParse::Param(FCommandLine::Get(), TEXT("FPSRecordEpisodes"));
+
+	// Spawned agents arrive over several frames, learning starts once they are all in
+	if (SpawnAgentCount > 0)
+	{
+		if (SpawnAgentCount > LearningAgentsManager->GetMaxAgentNum())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager %s: SpawnAgentCount %d exceeds MaxAgentNum %d, raise it with -FPSMaxAgents="),
+				*GetName(), SpawnAgentCount, LearningAgentsManager->GetMaxAgentNum());
+		}
+		bSpawningAgents = true;
+		return;
+	}
 	
 	// Initialize the learning system
 	InitializeAgents();
 	InitializeManager();
 }
 
-void AFPSCharacterManager::InitializeAgents()
+void AFPSCharacterManager::SpawnAgentBatch()
 {
-	// Get all FPSCharacter agents (including Blueprint-derived ones)
-	TArray<AActor*> Agents;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AFPSCharacter::StaticClass(), Agents);
-	
-	// Also try to find any Character-derived actors that might be blueprints
-	TArray<AActor*> AllCharacters;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ACharacter::StaticClass(), AllCharacters);
-	
-	// Filter characters to only include FPSCharacter and its derivatives
-	for (AActor* Actor : AllCharacters)
+	const int32 TargetCount = FMath::Min(SpawnAgentCount, LearningAgentsManager->GetMaxAgentNum());
+	const int32 BatchEnd = FMath::Min(AgentPool.GetActiveNum() + SpawnBatchSize, TargetCount);
+
+	bool bSpawnFailed = false;
+	for (int32 AgentIdx = AgentPool.GetActiveNum(); AgentIdx < BatchEnd; AgentIdx++)
 	{
-		if (IsValid(Actor) && Actor->IsA<AFPSCharacter>())
+		if (!AgentPool.Acquire(GetWorld(), AgentClass, AgentControllerClass, GetRandomSpawnTransform(), this))
 		{
-			if (!Agents.Contains(Actor)) // Avoid duplicates
-			{
-				Agents.Add(Actor);
-				UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: Added character %s (derived from FPSCharacter)"), *Actor->GetName());
-			}
+			UE_LOG(LogTemp, Error, TEXT("FPSCharacterManager %s: Failed to spawn agent of class %s"), *GetName(), *GetNameSafe(AgentClass));
+			bSpawnFailed = true;
+			break;
 		}
 	}
 
-	// Log comprehensive discovery information
-	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: ===== AGENT DISCOVERY SUMMARY ====="));
-	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: Found %d total characters in world"), AllCharacters.Num());
-	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: Found %d valid FPSCharacter agents"), Agents.Num());
-	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: Learning Manager MaxAgentNum: %d"), LearningAgentsManager->GetMaxAgentNum());
-	
-	// Log details about what we found
-	for (int32 i = 0; i < AllCharacters.Num(); i++)
+	if (AgentPool.GetActiveNum() >= TargetCount || bSpawnFailed)
 	{
-		AActor* Actor = AllCharacters[i];
-		if (!IsValid(Actor))
+		bSpawningAgents = false;
+		UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager %s: Spawned %d agents (%d pooled)"), *GetName(), AgentPool.GetActiveNum(), AgentPool.GetPooledNum());
+
+		InitializeAgents();
+		InitializeManager();
+	}
+}
+
+FTransform AFPSCharacterManager::GetRandomSpawnTransform() const
+{
+	FBox SpawnBox = FBox(GetActorLocation() - SpawnExtent, GetActorLocation() + SpawnExtent);
+	if (SpawnVolume)
+	{
+		SpawnBox = SpawnVolume->GetComponentsBoundingBox();
+	}
+
+	FVector Location = SpawnBox.GetCenter();
+	for (int32 Attempt = 0; Attempt < 10; Attempt++)
+	{
+		Location = FMath::RandPointInBox(SpawnBox);
+		if (!SpawnVolume || SpawnVolume->EncompassesPoint(Location))
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Character %d: INVALID ACTOR"), i);
-			continue;
+			break;
 		}
-		
-		bool bIsFPSCharacter = Actor->IsA<AFPSCharacter>();
-		UE_LOG(LogTemp, Warning, TEXT("Character %d: %s (Class: %s) - Is FPSCharacter: %s, In Agents List: %s"), 
-			i, 
-			*Actor->GetName(), 
-			*Actor->GetClass()->GetName(),
-			bIsFPSCharacter ? TEXT("YES") : TEXT("NO"),
-			Agents.Contains(Actor) ? TEXT("YES") : TEXT("NO"));
+	}
+
+	// Stand the agent on whatever is below the spawn area, but never on another agent
+	const float HalfHeight = AgentClass ? AgentClass.GetDefaultObject()->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() : 100.0f;
+	FHitResult Hit;
+	const FVector TraceStart(Location.X, Location.Y, SpawnBox.Max.Z + 1000.0f);
+	const FVector TraceEnd(Location.X, Location.Y, SpawnBox.Min.Z - 1000.0f);
+	FCollisionResponseParams ResponseParams;
+	ResponseParams.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore);
+	if (GetWorld()->LineTraceSingleByChannel(Hit, TraceStart, TraceEnd, ECC_WorldStatic, FCollisionQueryParams::DefaultQueryParam, ResponseParams))
+	{
+		Location.Z = Hit.Location.Z + HalfHeight;
+	}
+
+	return FTransform(FRotator(0.0f, FMath::FRandRange(0.0f, 360.0f), 0.0f), Location);
+}
+
+void AFPSCharacterManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Write out whatever the learning callbacks buffered during the session
+	FFPSLearningLog::Get().Flush();
+	EpisodeRecorder.End();
+
+	// Stop the session first. A trainer that loops sessions then goes idle and confirms it before being handed out
+	// again, the stock trainer exits
+	if (PPOTrainer && PPOTrainer->IsTraining())
+	{
+		PPOTrainer->EndTraining();
+	}
+
+	if (TrainerHandle != INDEX_NONE && GEngine)
+	{
+		GEngine->GetEngineSubsystem<UFPSTrainerProcessSubsystem>()->ReleaseTrainer(TrainerHandle, bKeepTrainerAlive);
+		TrainerHandle = INDEX_NONE;
+	}
+	bWaitingForTrainer = false;
+
+	if (UFPSSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSSignificanceSubsystem>())
+	{
+		for (AFPSCharacter* Agent : ManagedAgents)
+		{
+			Significance->UnregisterViewer(Agent);
+		}
+	}
+
+	// Release the agents so another manager can pick them up
+	ManagedAgents.Reset();
+	ManagedAgentIds.Reset();
+
+	// Park spawned agents with the rest of the pool, or destroy them all with the manager
+	if (EndPlayReason == EEndPlayReason::Destroyed)
+	{
+		AgentPool.Empty();
+	}
+	else
+	{
+		AgentPool.ReleaseAll();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AFPSCharacterManager::SetSpawnedAgentNum(int32 AgentNum)
+{
+	if (SpawnAgentCount <= 0 || bSpawningAgents)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager %s: Agent count can only change once spawned agents are running"), *GetName());
+		return;
+	}
+
+	AgentNum = FMath::Clamp(AgentNum, 0, LearningAgentsManager->GetMaxAgentNum());
+	UFPSSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSSignificanceSubsystem>();
+
+	while (ManagedAgents.Num() > AgentNum)
+	{
+		AFPSCharacter* Agent = ManagedAgents.Pop(EAllowShrinking::No);
+		const int32 AgentId = LearningAgentsManager->GetAgentId(Agent);
+		if (AgentId != INDEX_NONE)
+		{
+			LearningAgentsManager->RemoveAgent(AgentId);
+			ManagedAgentIds.Remove(AgentId);
+		}
+		if (Significance)
+		{
+			Significance->UnregisterViewer(Agent);
+		}
+		AgentPool.Release(Agent);
+	}
+
+	while (ManagedAgents.Num() < AgentNum)
+	{
+		AFPSCharacter* Agent = AgentPool.Acquire(GetWorld(), AgentClass, AgentControllerClass, GetRandomSpawnTransform(), this);
+		const int32 AgentId = Agent ? LearningAgentsManager->AddAgent(Agent) : INDEX_NONE;
+		if (AgentId == INDEX_NONE)
+		{
+			UE_LOG(LogTemp, Error, TEXT("FPSCharacterManager %s: Failed to add agent of class %s"), *GetName(), *GetNameSafe(AgentClass));
+			AgentPool.Release(Agent);
+			break;
+		}
+
+		Agent->AddTickPrerequisiteActor(this);
+		if (Significance)
+		{
+			Significance->RegisterViewer(Agent);
+		}
+		ManagedAgents.Add(Agent);
+		ManagedAgentIds.Add(AgentId);
+	}
+
+	SpawnAgentCount = ManagedAgents.Num();
+	UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager %s: Running %d agents (%d pooled)"), *GetName(), AgentPool.GetActiveNum(), AgentPool.GetPooledNum());
+}
+
+void AFPSCharacterManager::GatherAgentCandidates(TArray<AFPSCharacter*>& OutAgents) const
+{
+	// Spawned agents belong to this manager only
+	if (SpawnAgentCount > 0)
+	{
+		AgentPool.GetActive(OutAgents);
+		return;
+	}
+
+	// Includes Blueprint-derived characters
+	for (TActorIterator<AFPSCharacter> It(GetWorld()); It; ++It)
+	{
+		AFPSCharacter* Character = *It;
+		if (IsValid(Character) && MatchesAgentSelection(Character) && !IsAgentClaimedByOtherManager(Character))
+		{
+			OutAgents.Add(Character);
+		}
+	}
+}
+
+bool AFPSCharacterManager::MatchesAgentSelection(const AFPSCharacter* Character) const
+{
+	switch (AgentSelection)
+	{
+	case EFPSAgentSelection::Volume:
+		return AgentVolume && AgentVolume->EncompassesPoint(Character->GetActorLocation());
+	case EFPSAgentSelection::Tag:
+		return Character->ActorHasTag(AgentTag);
+	case EFPSAgentSelection::SpawnGroup:
+		return Character->GetOwner() == (SpawnGroup ? SpawnGroup : this);
+	default:
+		return true;
+	}
+}
+
+bool AFPSCharacterManager::IsAgentClaimedByOtherManager(const AFPSCharacter* Character) const
+{
+	for (TActorIterator<AFPSCharacterManager> It(GetWorld()); It; ++It)
+	{
+		if (*It != this && It->ManagedAgents.Contains(Character))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void AFPSCharacterManager::InitializeAgents()
+{
+	TArray<AFPSCharacter*> Candidates;
+	GatherAgentCandidates(Candidates);
+
+	TArray<AActor*> Agents;
+	Agents.Append(Candidates);
+
+	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager %s: ===== AGENT DISCOVERY SUMMARY ====="), *GetName());
+	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager %s: Selection: %s"), *GetName(), *UEnum::GetValueAsString(AgentSelection));
+	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager %s: Found %d unclaimed FPSCharacter agents"), *GetName(), Agents.Num());
+	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager %s: Learning Manager MaxAgentNum: %d"), *GetName(), LearningAgentsManager->GetMaxAgentNum());
+
+	if (Agents.Num() > LearningAgentsManager->GetMaxAgentNum())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager %s: Only the first %d agents will be registered"), *GetName(), LearningAgentsManager->GetMaxAgentNum());
+		Agents.SetNum(LearningAgentsManager->GetMaxAgentNum());
 	}
 
 	// FIXED: Clear any existing agents first to ensure clean state
 	LearningAgentsManager->RemoveAllAgents();
+	ManagedAgents.Reset();
+	ManagedAgentIds.Reset();
 
 	// Store agent registration results for verification
 	TArray<int32> SuccessfulAgentIds;
@@ -150,6 +386,7 @@ void AFPSCharacterManager::InitializeAgents()
 		}
 		
 		SuccessfulAgentIds.Add(AgentId);
+		ManagedAgents.Add(CastChecked<AFPSCharacter>(Agent));
 		UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: Successfully added agent %s to manager with ID %d"), *Agent->GetName(), AgentId);
 		
 		// Initialize agent for learning (disable player input, prepare for AI control)
@@ -186,6 +423,16 @@ void AFPSCharacterManager::InitializeAgents()
 	}
 	LearningAgentsManager->GetAgentIds(RegisteredAgentIds, AgentObjects);
 	int32 RegisteredAgentCount = RegisteredAgentIds.Num();
+	ManagedAgentIds = RegisteredAgentIds;
+
+	// Keep whatever is near the agents at full update rate
+	if (UFPSSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSSignificanceSubsystem>())
+	{
+		for (AFPSCharacter* Agent : ManagedAgents)
+		{
+			Significance->RegisterViewer(Agent);
+		}
+	}
 	
 	// Verify sequential IDs
 	bool bHasSequentialIds = true;
@@ -205,10 +452,11 @@ void AFPSCharacterManager::InitializeAgents()
 	
 	if (Agents.Num() == 0)
 	{
-		UE_LOG(LogTemp, Error, TEXT("FPSCharacterManager: No FPSCharacter agents found! Make sure to:"));
+		UE_LOG(LogTemp, Error, TEXT("FPSCharacterManager %s: No unclaimed FPSCharacter agents match the agent selection! Make sure to:"), *GetName());
 		UE_LOG(LogTemp, Error, TEXT("1. Place FPSCharacter (or Blueprint derived from FPSCharacter) actors in your level"));
 		UE_LOG(LogTemp, Error, TEXT("2. Don't just set FPSCharacter as PlayerPawn - you need actual actors in the world"));
 		UE_LOG(LogTemp, Error, TEXT("3. Check that your Blueprint inherits from FPSCharacter, not just Character"));
+		UE_LOG(LogTemp, Error, TEXT("4. Check AgentVolume / AgentTag / SpawnGroup, and that another manager hasn't already claimed the agents"));
 	}
 	else if (RegisteredAgentCount < Agents.Num())
 	{
@@ -239,26 +487,8 @@ void AFPSCharacterManager::InitializeManager()
 	// Should neural networks be re-initialized
 	const bool ReInitialize = (RunMode == EFPSCharacterManagerMode::ReInitialize);
 
-	// FIXED: Get current agent count for multi-agent setup verification
-	TArray<int32> AgentIds;
-	TArray<UObject*> AllAgentObjects;
-	
-	// Get all managed agents
-	TArray<AActor*> Agents;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AFPSCharacter::StaticClass(), Agents);
-	for (AActor* Agent : Agents)
-	{
-		if (IsValid(Agent))
-		{
-			AllAgentObjects.Add(Agent);
-		}
-	}
-	
-	if (AllAgentObjects.Num() > 0)
-	{
-		LearningAgentsManager->GetAgentIds(AgentIds, AllAgentObjects);
-	}
-	int32 AgentCount = AgentIds.Num();
+	// Only this manager's agents take part
+	int32 AgentCount = ManagedAgentIds.Num();
 	
 	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: ===== MANAGER INITIALIZATION ====="));
 	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: Agent count for training: %d"), AgentCount);
@@ -330,19 +560,54 @@ void AFPSCharacterManager::InitializeManager()
 	}
 	TrainingEnvironment->TargetActor = TargetActor;
 	TrainingEnvironmentBase = TrainingEnvironment;
+
+	EpisodeStatistics.Initialize(LearningAgentsManager->GetMaxAgentNum());
+	TrainingEnvironment->EpisodeStatistics = &EpisodeStatistics;
 	UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager: Created Training Environment successfully"));
 
-	// Create a shared memory communicator to spawn a training process (following car example)
-	FLearningAgentsCommunicator Communicator = ULearningAgentsCommunicatorLibrary::MakeSharedMemoryTrainingProcess(
-		TrainerProcessSettings, SharedMemorySettings
-	);
-	UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager: Created Communicator successfully"));
+	if (!ReInitialize)
+	{
+		UpdatePublishedWeights();
+	}
+
+	// Inference only runs the policy, so don't pay for spawning a trainer process
+	if (RunMode == EFPSCharacterManagerMode::Inference)
+	{
+		UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager: Inference mode - skipping trainer process. Agents: %d"), AgentCount);
+		UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: ===== MANAGER INITIALIZATION COMPLETE ====="));
+		return;
+	}
+
+	// The trainer process was requested in PostInitializeComponents; training starts once it is up
+	if (TrainerHandle == INDEX_NONE && GEngine)
+	{
+		TrainerHandle = GEngine->GetEngineSubsystem<UFPSTrainerProcessSubsystem>()->RequestTrainer(TrainerProcessSettings, SharedMemorySettings);
+	}
+	bWaitingForTrainer = true;
+	TrainerWaitStartTime = FPlatformTime::Seconds();
+	TryCreatePPOTrainer();
+
+	UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager: Initialization complete. Mode: %d, Agents: %d"), (int32)RunMode, AgentCount);
+	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: ===== MANAGER INITIALIZATION COMPLETE ====="));
+}
+
+void AFPSCharacterManager::TryCreatePPOTrainer()
+{
+	FLearningAgentsCommunicator Communicator;
+	if (!GEngine || !GEngine->GetEngineSubsystem<UFPSTrainerProcessSubsystem>()->TryGetTrainer(TrainerHandle, Communicator))
+	{
+		return;
+	}
+	bWaitingForTrainer = false;
+	UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager: Trainer ready after waiting %.2f s"), FPlatformTime::Seconds() - TrainerWaitStartTime);
 
 	// FIXED: Ensure trainer settings are appropriate for multi-agent
 	FLearningAgentsPPOTrainerSettings ModifiedTrainerSettings = TrainerSettings;
-	UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager: Using trainer settings for %d agents"), AgentCount);
+	UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager: Using trainer settings for %d agents"), ManagedAgentIds.Num());
 
 	// Make PPO Trainer Instance
+	ULearningAgentsManager* ManagerPtr = LearningAgentsManager;
+	ULearningAgentsInteractor* InteractorPtr = Interactor;
 	PPOTrainer = ULearningAgentsPPOTrainer::MakePPOTrainer(
 		ManagerPtr, InteractorPtr, TrainingEnvironmentBase, Policy, Critic,
 		Communicator, ULearningAgentsPPOTrainer::StaticClass(), TEXT("FPSCharacter PPO Trainer"), ModifiedTrainerSettings);
@@ -352,67 +617,24 @@ void AFPSCharacterManager::InitializeManager()
 		return;
 	}
 	UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager: Created PPO Trainer successfully"));
-
-	UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager: Initialization complete. Mode: %d, Agents: %d"), (int32)RunMode, AgentCount);
-	UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager: ===== MANAGER INITIALIZATION COMPLETE ====="));
 }
 
 void AFPSCharacterManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// DEBUG: Periodic status logging for all agents
-	static float DebugTimer = 0.0f;
-	DebugTimer += DeltaTime;
-	if (DebugTimer >= 2.0f) // Log every 2 seconds
+	if (bSpawningAgents)
 	{
-		DebugTimer = 0.0f;
-		
-		// Get agent count and IDs
-		TArray<int32> AgentIds;
-		TArray<UObject*> AllAgentObjects;
-		
-		// Get all managed agents
-		TArray<AActor*> Agents;
-		UGameplayStatics::GetAllActorsOfClass(GetWorld(), AFPSCharacter::StaticClass(), Agents);
-		for (AActor* Agent : Agents)
-		{
-			if (IsValid(Agent))
-			{
-				AllAgentObjects.Add(Agent);
-			}
-		}
-		
-		if (AllAgentObjects.Num() > 0)
-		{
-			LearningAgentsManager->GetAgentIds(AgentIds, AllAgentObjects);
-		}
-		
-		UE_LOG(LogTemp, Warning, TEXT("=== AGENT STATUS DEBUG ==="));
-		UE_LOG(LogTemp, Warning, TEXT("Total registered agents: %d"), AgentIds.Num());
-		UE_LOG(LogTemp, Warning, TEXT("Run Mode: %s"), 
-			RunMode == EFPSCharacterManagerMode::Training ? TEXT("Training") : 
-			RunMode == EFPSCharacterManagerMode::Inference ? TEXT("Inference") : TEXT("ReInitialize"));
-		
-		for (int32 AgentId : AgentIds)
-		{
-			AFPSCharacter* Character = Cast<AFPSCharacter>(LearningAgentsManager->GetAgent(AgentId, AFPSCharacter::StaticClass()));
-			if (Character)
-			{
-				FVector Velocity = Character->GetCharacterMovement() ? Character->GetCharacterMovement()->Velocity : FVector::ZeroVector;
-				UE_LOG(LogTemp, Warning, TEXT("Agent %d (%s): Location=(%s), Velocity=(%s), Moving=%s"), 
-					AgentId, 
-					*Character->GetName(),
-					*Character->GetActorLocation().ToString(),
-					*Velocity.ToString(),
-					Velocity.Size() > 1.0f ? TEXT("YES") : TEXT("NO"));
-			}
-			else
-			{
-				UE_LOG(LogTemp, Error, TEXT("Agent %d: CHARACTER NOT FOUND"), AgentId);
-			}
-		}
-		UE_LOG(LogTemp, Warning, TEXT("========================"));
+		SpawnAgentBatch();
+		return;
+	}
+
+	// Periodic episode statistics summary
+	StatisticsTimer += DeltaTime;
+	if (StatisticsTimer >= StatisticsInterval)
+	{
+		StatisticsTimer = 0.0f;
+		EmitEpisodeStatistics();
 	}
 
 	// Handle different run modes like in car example
@@ -420,6 +642,13 @@ void AFPSCharacterManager::Tick(float DeltaTime)
 	{
 		if (Policy != nullptr)
 		{
+			PublishedWeightsTimer += DeltaTime;
+			if (PublishedWeightsTimer >= PublishedWeightsPollInterval)
+			{
+				PublishedWeightsTimer = 0.0f;
+				UpdatePublishedWeights();
+			}
+
 			Policy->RunInference();
 		}
 		else
@@ -432,10 +661,270 @@ void AFPSCharacterManager::Tick(float DeltaTime)
 		if (PPOTrainer != nullptr)
 		{
 			PPOTrainer->RunTraining(TrainingSettings, TrainingGameSettings, true, true);
+
+			if (WeightsPublishInterval > 0.0f)
+			{
+				PublishedWeightsTimer += DeltaTime;
+				if (PublishedWeightsTimer >= WeightsPublishInterval)
+				{
+					PublishedWeightsTimer = 0.0f;
+					PublishWeights();
+				}
+			}
+		}
+		else if (bWaitingForTrainer)
+		{
+			// Agents stand still until the trainer process has started
+			TryCreatePPOTrainer();
 		}
 		else
 		{
 			UE_LOG(LogTemp, Error, TEXT("FPSCharacterManager: PPOTrainer is null in Training mode"));
 		}
 	}
-} 
+
+	if (bRecordEpisodes)
+	{
+		RecordFrame();
+	}
+}
+
+FString AFPSCharacterManager::GetPublishedWeightsDirectory() const
+{
+	FString Directory = PublishedWeightsDirectory.Path;
+	FParse::Value(FCommandLine::Get(), TEXT("FPSPublishedWeights="), Directory);
+	if (!Directory.IsEmpty() && FPaths::IsRelative(Directory))
+	{
+		Directory = FPaths::ProjectDir() / Directory;
+	}
+	return Directory;
+}
+
+void AFPSCharacterManager::UpdatePublishedWeights()
+{
+	const FString Directory = GetPublishedWeightsDirectory();
+	if (Directory.IsEmpty())
+	{
+		return;
+	}
+
+	ULearningAgentsNeuralNetwork* Networks[] = { EncoderNeuralNetwork, PolicyNeuralNetwork, DecoderNeuralNetwork, CriticNeuralNetwork };
+	const TCHAR* Names[] = { TEXT("Encoder"), TEXT("Policy"), TEXT("Decoder"), TEXT("Critic") };
+	PublishedWeights.Update(Networks, Names, Directory);
+}
+
+void AFPSCharacterManager::PublishWeights()
+{
+	const FString Directory = GetPublishedWeightsDirectory();
+	if (Directory.IsEmpty())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPSCharacterManager %s: No PublishedWeightsDirectory to publish to"), *GetName());
+		return;
+	}
+
+	ULearningAgentsNeuralNetwork* Networks[] = { EncoderNeuralNetwork, PolicyNeuralNetwork, DecoderNeuralNetwork, CriticNeuralNetwork };
+	const TCHAR* Names[] = { TEXT("Encoder"), TEXT("Policy"), TEXT("Decoder"), TEXT("Critic") };
+	FFPSPublishedNetworkWeights::Publish(Networks, Names, Directory);
+}
+
+void AFPSCharacterManager::EmitEpisodeStatistics()
+{
+	FFPSEpisodeSummary Summary;
+	EpisodeStatistics.Summarize(Summary, StatisticsHistogramBins);
+	StatisticsStep++;
+
+	if (Summary.Episodes == 0)
+	{
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager %s: %d episodes, mean return %.3f, mean length %.1f, success rate %.2f"),
+		*GetName(), Summary.Episodes, Summary.Return.Mean(), Summary.Length.Mean(), Summary.SuccessRate());
+
+	if (bWriteStatisticsFile)
+	{
+		TSharedRef<FJsonObject> Json = Summary.ToJson();
+		Json->SetStringField(TEXT("manager"), GetName());
+		Json->SetNumberField(TEXT("interval"), (double)StatisticsStep);
+		Json->SetNumberField(TEXT("time"), GetWorld()->GetTimeSeconds());
+
+		FString Line;
+		TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Line);
+		FJsonSerializer::Serialize(Json, Writer);
+		Line += LINE_TERMINATOR;
+
+		const FString FilePath = FPaths::ProjectSavedDir() / TEXT("LearningStatistics") / (GetName() + TEXT(".jsonl"));
+		FFileHelper::SaveStringToFile(Line, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append);
+	}
+
+	if (TrainingSettings.bUseTensorboard)
+	{
+		if (!StatisticsTensorboardWriter.IsOpen())
+		{
+			// Alongside the trainer's own runs so both show up in the same TensorBoard instance
+			const FString RunDirectory = FPaths::ProjectIntermediateDir() / TEXT("LearningAgents") / TEXT("TensorBoard") / TEXT("runs") /
+				FString::Printf(TEXT("%s_Episodes_%s"), *GetName(), *FDateTime::Now().ToString());
+			StatisticsTensorboardWriter.Open(RunDirectory);
+		}
+
+		StatisticsTensorboardWriter.AddScalar(TEXT("episodes/return_mean"), Summary.Return.Mean(), StatisticsStep);
+		StatisticsTensorboardWriter.AddScalar(TEXT("episodes/length_mean"), Summary.Length.Mean(), StatisticsStep);
+		StatisticsTensorboardWriter.AddScalar(TEXT("episodes/success_rate"), Summary.SuccessRate(), StatisticsStep);
+		StatisticsTensorboardWriter.AddScalar(TEXT("episodes/count"), Summary.Episodes, StatisticsStep);
+		StatisticsTensorboardWriter.AddHistogram(TEXT("episodes/return"), Summary.Return, StatisticsStep);
+		StatisticsTensorboardWriter.AddHistogram(TEXT("episodes/length"), Summary.Length, StatisticsStep);
+
+		for (int32 TermIdx = 0; TermIdx < (int32)EFPSRewardTerm::Num; TermIdx++)
+		{
+			StatisticsTensorboardWriter.AddScalar(
+				FString::Printf(TEXT("reward_terms/%s"), FFPSEpisodeStatistics::GetRewardTermName((EFPSRewardTerm)TermIdx)),
+				Summary.MeanTerms.Values[TermIdx], StatisticsStep);
+		}
+
+		for (int32 ReasonIdx = 0; ReasonIdx < (int32)EFPSEpisodeTermination::Num; ReasonIdx++)
+		{
+			StatisticsTensorboardWriter.AddScalar(
+				FString::Printf(TEXT("terminations/%s"), FFPSEpisodeStatistics::GetTerminationName((EFPSEpisodeTermination)ReasonIdx)),
+				Summary.TerminationCounts[ReasonIdx], StatisticsStep);
+		}
+
+		StatisticsTensorboardWriter.Flush();
+	}
+}
+
+void AFPSCharacterManager::RecordFrame()
+{
+	if (!EpisodeRecorder.IsRecording())
+	{
+		const FString FilePath = FPaths::ProjectSavedDir() / TEXT("LearningRecordings") /
+			FString::Printf(TEXT("%s_%s.fpsrec"), *GetName(), *FDateTime::Now().ToString());
+		if (!EpisodeRecorder.Begin(FilePath, RecordingKeyframeInterval))
+		{
+			UE_LOG(LogTemp, Error, TEXT("FPSCharacterManager %s: Failed to open episode recording %s, recording disabled"), *GetName(), *FilePath);
+			bRecordEpisodes = false;
+			return;
+		}
+		UE_LOG(LogTemp, Log, TEXT("FPSCharacterManager %s: Recording episodes to %s"), *GetName(), *FilePath);
+	}
+
+	RecordingFrame.Time = GetWorld()->GetTimeSeconds();
+	RecordingFrame.TargetLocation = TargetActor ? TargetActor->GetActorLocation() : FVector::ZeroVector;
+	RecordingFrame.Agents.Reset();
+
+	for (const int32 AgentId : ManagedAgentIds)
+	{
+		const AFPSCharacter* Character = Cast<AFPSCharacter>(LearningAgentsManager->GetAgent(AgentId, AFPSCharacter::StaticClass()));
+		if (!Character)
+		{
+			continue;
+		}
+
+		FFPSRecordedAgent& Agent = RecordingFrame.Agents.AddDefaulted_GetRef();
+		Agent.AgentId = AgentId;
+		Agent.Location = Character->GetActorLocation();
+		Agent.Yaw = Character->GetActorRotation().Yaw;
+		Agent.Pitch = Character->GetControlRotation().Pitch;
+		Agent.Actions = Interactor ? Interactor->GetLastAction(AgentId) : FVector4f(0.0f, 0.0f, 0.0f, 0.0f);
+		if (TrainingEnvironment)
+		{
+			Agent.Reward = TrainingEnvironment->GetLastReward(AgentId);
+			Agent.EpisodeStep = TrainingEnvironment->GetEpisodeStep(AgentId);
+		}
+	}
+
+	EpisodeRecorder.AddFrame(RecordingFrame);
+}
+
+void AFPSCharacterManager::CaptureSnapshot(FFPSWorldSnapshot& OutSnapshot) const
+{
+	OutSnapshot.Agents.Reset();
+	OutSnapshot.WorldTime = GetWorld()->GetTimeSeconds();
+	OutSnapshot.TargetTransform = TargetActor ? TargetActor->GetActorTransform() : FTransform::Identity;
+
+	for (const int32 AgentId : ManagedAgentIds)
+	{
+		const AFPSCharacter* Character = Cast<AFPSCharacter>(LearningAgentsManager->GetAgent(AgentId, AFPSCharacter::StaticClass()));
+		if (!Character)
+		{
+			continue;
+		}
+
+		FFPSAgentSnapshot& Agent = OutSnapshot.Agents.AddDefaulted_GetRef();
+		Agent.AgentId = AgentId;
+		Agent.Transform = Character->GetActorTransform();
+		Agent.Velocity = Character->GetCharacterMovement() ? Character->GetCharacterMovement()->Velocity : FVector::ZeroVector;
+		Agent.ControlRotation = Character->GetControlRotation();
+		if (TrainingEnvironment)
+		{
+			TrainingEnvironment->GetAgentEpisodeState(AgentId, Agent.Episode);
+		}
+	}
+
+	OutSnapshot.bValid = true;
+}
+
+bool AFPSCharacterManager::RestoreSnapshot(const FFPSWorldSnapshot& Snapshot)
+{
+	if (!Snapshot.IsValid())
+	{
+		return false;
+	}
+
+	if (TargetActor)
+	{
+		TargetActor->SetActorTransform(Snapshot.TargetTransform, false, nullptr, ETeleportType::ResetPhysics);
+	}
+
+	// Looked up once per snapshot agent, so built once instead of searching ManagedAgentIds each time
+	TBitArray<> IsManaged(false, LearningAgentsManager->GetMaxAgentNum());
+	for (const int32 AgentId : ManagedAgentIds)
+	{
+		if (IsManaged.IsValidIndex(AgentId))
+		{
+			IsManaged[AgentId] = true;
+		}
+	}
+
+	for (const FFPSAgentSnapshot& Agent : Snapshot.Agents)
+	{
+		if (!IsManaged.IsValidIndex(Agent.AgentId) || !IsManaged[Agent.AgentId])
+		{
+			continue;
+		}
+
+		AFPSCharacter* Character = Cast<AFPSCharacter>(LearningAgentsManager->GetAgent(Agent.AgentId, AFPSCharacter::StaticClass()));
+		if (!Character)
+		{
+			continue;
+		}
+
+		Character->SetActorTransform(Agent.Transform, false, nullptr, ETeleportType::ResetPhysics);
+		if (UCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement())
+		{
+			MovementComponent->Velocity = Agent.Velocity;
+		}
+		if (AController* Controller = Character->GetController())
+		{
+			Controller->SetControlRotation(Agent.ControlRotation);
+		}
+		if (TrainingEnvironment)
+		{
+			TrainingEnvironment->SetAgentEpisodeState(Agent.AgentId, Agent.Episode);
+		}
+	}
+
+	return true;
+}
+
+void AFPSCharacterManager::SaveSnapshotSlot(int32 Slot)
+{
+	FFPSWorldSnapshot& Snapshot = SnapshotSlots.FindOrAdd(Slot);
+	Snapshot.Reserve(LearningAgentsManager->GetMaxAgentNum());
+	CaptureSnapshot(Snapshot);
+}
+
+bool AFPSCharacterManager::RestoreSnapshotSlot(int32 Slot)
+{
+	const FFPSWorldSnapshot* Snapshot = SnapshotSlots.Find(Slot);
+	return Snapshot && RestoreSnapshot(*Snapshot);
+}
@@ -10,6 +10,14 @@
 #include "LearningAgentsPPOTrainer.h"
 #include "LearningAgentsManager.h"
 #include "LearningAgentsCommunicator.h"
+#include "FPSEpisodeStatistics.h"
+#include "FPSTensorboardWriter.h"
+#include "FPSRayFanSensor.h"
+#include "FPSSpatialHash.h"
+#include "FPSAgentPool.h"
+#include "FPSEpisodeRecorder.h"
+#include "FPSWorldSnapshot.h"
+#include "FPSPublishedNetworkWeights.h"
 #include "FPSCharacterManager.generated.h"
 
 class UFPSCharacterManagerComponent;
@@ -17,6 +25,9 @@ class UFPSCharacterInteractor;
 class UFPSCharacterTrainingEnvironment;
 class AFPSTargetActor;
 class ULearningAgentsNeuralNetwork;
+class AFPSCharacter;
+class AVolume;
+class AController;
 
 UENUM(BlueprintType)
 enum class EFPSCharacterManagerMode : uint8
@@ -26,6 +37,16 @@ enum class EFPSCharacterManagerMode : uint8
 	ReInitialize	UMETA(DisplayName = "ReInitialize")
 };
 
+// Which characters in the world a manager takes control of
+UENUM(BlueprintType)
+enum class EFPSAgentSelection : uint8
+{
+	All				UMETA(DisplayName = "All Unclaimed"),
+	Volume			UMETA(DisplayName = "Inside Volume"),
+	Tag				UMETA(DisplayName = "Actor Tag"),
+	SpawnGroup		UMETA(DisplayName = "Spawn Group")
+};
+
 /**
  * Main manager for FPSCharacter learning agents
  */
@@ -38,7 +59,9 @@ public:
 	AFPSCharacterManager();
 
 protected:
+	virtual void PostInitializeComponents() override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// Core learning components
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Components")
@@ -69,9 +92,94 @@ protected:
 	void InitializeAgents();
 	void InitializeManager();
 
+	// Creates the PPO trainer once the trainer process requested from UFPSTrainerProcessSubsystem is up
+	void TryCreatePPOTrainer();
+
+	// Loads newly published weights into the networks
+	void UpdatePublishedWeights();
+
+	FString GetPublishedWeightsDirectory() const;
+
+	// Encoder, policy, decoder and critic, loaded as one set
+	FFPSPublishedNetworkWeights PublishedWeights;
+	float PublishedWeightsTimer = 0.0f;
+
+	int32 TrainerHandle = INDEX_NONE;
+	bool bWaitingForTrainer = false;
+	double TrainerWaitStartTime = 0.0;
+
+	// Collects the characters matching AgentSelection that no other manager has claimed
+	void GatherAgentCandidates(TArray<AFPSCharacter*>& OutAgents) const;
+	bool MatchesAgentSelection(const AFPSCharacter* Character) const;
+	bool IsAgentClaimedByOtherManager(const AFPSCharacter* Character) const;
+
+	// Characters owned by this manager
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Agents")
+	TArray<AFPSCharacter*> ManagedAgents;
+
+	// Spawns up to SpawnBatchSize pooled agents, then initializes learning once all are in
+	void SpawnAgentBatch();
+	FTransform GetRandomSpawnTransform() const;
+
+	UPROPERTY()
+	FFPSAgentPool AgentPool;
+
+	bool bSpawningAgents = false;
+
+	// Agent ids successfully registered with the learning manager
+	TArray<int32> ManagedAgentIds;
+
+	// Episode statistics gathered by the training environment
+	void EmitEpisodeStatistics();
+
+	FFPSEpisodeStatistics EpisodeStatistics;
+	FFPSTensorboardWriter StatisticsTensorboardWriter;
+	float StatisticsTimer = 0.0f;
+	int64 StatisticsStep = 0;
+
+	// Appends this step's agent states to the episode recording
+	void RecordFrame();
+
+	FFPSEpisodeRecorder EpisodeRecorder;
+	FFPSRecordedFrame RecordingFrame;
+
+	// Snapshots kept for the Blueprint slot functions
+	TMap<int32, FFPSWorldSnapshot> SnapshotSlots;
+
 public:	
 	virtual void Tick(float DeltaTime) override;
 
+	// Accessors used by tests and tooling that drive the learning objects directly
+	UFPSCharacterManagerComponent* GetLearningAgentsManager() const { return LearningAgentsManager; }
+	UFPSCharacterInteractor* GetInteractor() const { return Interactor; }
+	UFPSCharacterTrainingEnvironment* GetTrainingEnvironment() const { return TrainingEnvironment; }
+	ULearningAgentsPolicy* GetPolicy() const { return Policy; }
+	const TArray<int32>& GetManagedAgentIds() const { return ManagedAgentIds; }
+	const TArray<AFPSCharacter*>& GetManagedAgents() const { return ManagedAgents; }
+
+	/**
+	 * Captures every managed agent's transform, velocity and control rotation, the target transform and the
+	 * environment's episode counters. Reserve the snapshot for GetLearningAgentsManager()->GetMaxAgentNum() agents
+	 * to keep capture allocation free. Random resets after a restore are only reproduced if the caller reseeds.
+	 */
+	void CaptureSnapshot(FFPSWorldSnapshot& OutSnapshot) const;
+
+	// Puts agents, target and episode counters back as captured. Agents no longer managed are skipped
+	bool RestoreSnapshot(const FFPSWorldSnapshot& Snapshot);
+
+	UFUNCTION(BlueprintCallable, Category = "Snapshots")
+	void SaveSnapshotSlot(int32 Slot);
+
+	UFUNCTION(BlueprintCallable, Category = "Snapshots")
+	bool RestoreSnapshotSlot(int32 Slot);
+
+	/**
+	 * Changes how many spawned agents take part while running. Removed agents are parked in the agent pool and
+	 * added ones are taken from it before anything new is spawned. Only for managers spawning their own agents.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Agents|Spawning")
+	void SetSpawnedAgentNum(int32 AgentNum);
+
 	// Manager settings
 	UPROPERTY(EditAnywhere, Category = "Manager Settings")
 	EFPSCharacterManagerMode RunMode = EFPSCharacterManagerMode::Training;
@@ -79,6 +187,41 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Manager Settings")
 	int32 RandomSeed = 1234;
 
+	// Agent selection - several managers can run side by side as long as their agent sets are disjoint
+	UPROPERTY(EditAnywhere, Category = "Agents")
+	EFPSAgentSelection AgentSelection = EFPSAgentSelection::All;
+
+	UPROPERTY(EditAnywhere, Category = "Agents", meta = (EditCondition = "AgentSelection == EFPSAgentSelection::Volume"))
+	AVolume* AgentVolume = nullptr;
+
+	UPROPERTY(EditAnywhere, Category = "Agents", meta = (EditCondition = "AgentSelection == EFPSAgentSelection::Tag"))
+	FName AgentTag;
+
+	// Characters owned by this actor form the group. Defaults to the manager itself
+	UPROPERTY(EditAnywhere, Category = "Agents", meta = (EditCondition = "AgentSelection == EFPSAgentSelection::SpawnGroup"))
+	AActor* SpawnGroup = nullptr;
+
+	// When above zero the manager spawns this many agents itself instead of using placed ones. -FPSSpawnAgents=N overrides it
+	UPROPERTY(EditAnywhere, Category = "Agents|Spawning", meta = (ClampMin = "0"))
+	int32 SpawnAgentCount = 0;
+
+	UPROPERTY(EditAnywhere, Category = "Agents|Spawning")
+	TSubclassOf<AFPSCharacter> AgentClass;
+
+	UPROPERTY(EditAnywhere, Category = "Agents|Spawning")
+	TSubclassOf<AController> AgentControllerClass;
+
+	// Agents are placed at random inside this volume, or within SpawnExtent of the manager when unset
+	UPROPERTY(EditAnywhere, Category = "Agents|Spawning")
+	AVolume* SpawnVolume = nullptr;
+
+	UPROPERTY(EditAnywhere, Category = "Agents|Spawning")
+	FVector SpawnExtent = FVector(2000.0f, 2000.0f, 0.0f);
+
+	// Agents spawned per frame, so large counts don't hitch startup
+	UPROPERTY(EditAnywhere, Category = "Agents|Spawning", meta = (ClampMin = "1"))
+	int32 SpawnBatchSize = 16;
+
 	// Learning settings
 	UPROPERTY(EditAnywhere, Category = "Learning Settings")
 	FLearningAgentsPolicySettings PolicySettings;
@@ -92,6 +235,35 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Learning Settings")
 	FLearningAgentsTrainingGameSettings TrainingGameSettings;
 
+	// Leave the trainer process running when this manager goes away so the next level load can reattach to it.
+	// Also enabled with -FPSKeepTrainer. Only takes effect with bTrainerLoopsSessions
+	UPROPERTY(EditAnywhere, Category = "Learning Settings")
+	bool bKeepTrainerAlive = false;
+
+	// Set when the trainer script goes back to waiting for a new session after it is told to stop training. The
+	// stock Learning Agents trainer exits instead, so there is nothing to keep alive and bKeepTrainerAlive is ignored
+	UPROPERTY(EditAnywhere, Category = "Learning Settings")
+	bool bTrainerLoopsSessions = false;
+
+	// Episode statistics settings
+	UPROPERTY(EditAnywhere, Category = "Statistics", meta = (ClampMin = "0.1"))
+	float StatisticsInterval = 10.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Statistics", meta = (ClampMin = "1"))
+	int32 StatisticsHistogramBins = 10;
+
+	// Appends one JSON line per interval to Saved/LearningStatistics/<ManagerName>.jsonl
+	UPROPERTY(EditAnywhere, Category = "Statistics")
+	bool bWriteStatisticsFile = true;
+
+	// Record agent transforms, actions and rewards every step to Saved/LearningRecordings for replay with
+	// AFPSEpisodeReplayActor. Also enabled with -FPSRecordEpisodes
+	UPROPERTY(EditAnywhere, Category = "Recording")
+	bool bRecordEpisodes = false;
+
+	UPROPERTY(EditAnywhere, Category = "Recording", meta = (ClampMin = "1"))
+	int32 RecordingKeyframeInterval = 60;
+
 	// Neural network references
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Neural Networks")
 	ULearningAgentsNeuralNetwork* EncoderNeuralNetwork;
@@ -105,10 +277,34 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Neural Networks")
 	ULearningAgentsNeuralNetwork* CriticNeuralNetwork;
 
+	// Load the networks from the snapshots published in this directory instead of the assets, so processes on one
+	// machine run the same set of weights. Inference reloads whenever a new version is published. -FPSPublishedWeights=<Dir> sets it
+	UPROPERTY(EditAnywhere, Category = "Neural Networks")
+	FDirectoryPath PublishedWeightsDirectory;
+
+	UPROPERTY(EditAnywhere, Category = "Neural Networks", meta = (ClampMin = "0.1"))
+	float PublishedWeightsPollInterval = 5.0f;
+
+	// Training publishes the networks to PublishedWeightsDirectory this often. Zero disables it
+	UPROPERTY(EditAnywhere, Category = "Neural Networks", meta = (ClampMin = "0"))
+	float WeightsPublishInterval = 0.0f;
+
+	// Writes the current networks to PublishedWeightsDirectory as a new version
+	UFUNCTION(BlueprintCallable, Category = "Neural Networks")
+	void PublishWeights();
+
 	// Target actor reference
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Environment")
 	AFPSTargetActor* TargetActor;
 
+	// Ray-fan obstacle observation. Changing it changes the observation schema, so networks must be re-initialized
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Observations")
+	FFPSRayFanSettings RayFanSettings;
+
+	// K-nearest-agent observation, also part of the observation schema
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Observations")
+	FFPSNeighborSettings NeighborSettings;
+
 	// Trainer settings - expose these to editor like in car example
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Learning Objects")
 	FLearningAgentsTrainerProcessSettings TrainerProcessSettings;
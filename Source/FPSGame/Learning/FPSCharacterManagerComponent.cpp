@@ -1,6 +1,8 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
 #include "FPSCharacterManagerComponent.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 
 UFPSCharacterManagerComponent::UFPSCharacterManagerComponent()
 {
@@ -9,6 +11,10 @@ UFPSCharacterManagerComponent::UFPSCharacterManagerComponent()
 
 void UFPSCharacterManagerComponent::PostInitProperties()
 {
-	MaxAgentNum = 128; // Set maximum number of agents this manager can handle
+	// Has to be set before the base class sizes its agent storage
+	int32 CommandLineMaxAgentNum = 0;
+	MaxAgentNum = FParse::Value(FCommandLine::Get(), TEXT("FPSMaxAgents="), CommandLineMaxAgentNum) && CommandLineMaxAgentNum > 0
+		? CommandLineMaxAgentNum
+		: FMath::Max(DefaultMaxAgentNum, 1);
 	Super::PostInitProperties();
 } 
\ No newline at end of file
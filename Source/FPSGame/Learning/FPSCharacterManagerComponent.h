@@ -9,7 +9,7 @@
 /**
  * Manager component for FPSCharacter learning agents
  */
-UCLASS(BlueprintType, Blueprintable, ClassGroup = (LearningAgents), meta = (BlueprintSpawnableComponent))
+UCLASS(BlueprintType, Blueprintable, config = Game, ClassGroup = (LearningAgents), meta = (BlueprintSpawnableComponent))
 class FPSGAME_API UFPSCharacterManagerComponent : public ULearningAgentsManager
 {
 	GENERATED_BODY()
@@ -17,6 +17,10 @@ class FPSGAME_API UFPSCharacterManagerComponent : public ULearningAgentsManager
 public:
 	UFPSCharacterManagerComponent();
 
+	// Maximum number of agents, read from [/Script/FPSGame.FPSCharacterManagerComponent] and overridable with -FPSMaxAgents=N
+	UPROPERTY(config, EditDefaultsOnly, Category = "LearningAgents", meta = (ClampMin = "1"))
+	int32 DefaultMaxAgentNum = 128;
+
 protected:
 	virtual void PostInitProperties() override;
 }; 
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "LearningAgentsManager.h"
 #include "LearningAgentsCompletions.h"
 #include "FPSTargetActor.h"
+#include "FPSEpisodeStatistics.h"
+#include "FPSLearningLog.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "FPSCharacter.h"
 
@@ -12,6 +14,31 @@ UFPSCharacterTrainingEnvironment::UFPSCharacterTrainingEnvironment()
 	TargetActor = nullptr;
 }
 
+void UFPSCharacterTrainingEnvironment::GatherAgentRewards_Implementation(TArray<float>& OutRewards, const TArray<int32>& AgentIds)
+{
+	// Once per step: keep the navigation field in sync with the target
+	if (bUseNavigationDistance && TargetActor)
+	{
+		if (!NavigationField.HasOccupancy())
+		{
+			FFPSNavDistanceField::FSettings NavigationSettings;
+			NavigationSettings.Center = ResetCenter;
+			NavigationSettings.Extent = ResetBounds;
+			NavigationSettings.CellSize = NavigationCellSize;
+			NavigationSettings.ProbeHeight = NavigationProbeHeight;
+			NavigationSettings.ProbeRadius = NavigationProbeRadius;
+			NavigationField.BuildOccupancy(TargetActor->GetWorld(), NavigationSettings, TargetActor);
+
+			FPS_LEARNING_LOG(Reward, Log, TEXT("FPSCharacterTrainingEnvironment: Navigation grid built, %d blocked cells"), NavigationField.GetBlockedCellNum());
+		}
+
+		NavigationField.RequestUpdate(TargetActor->GetActorLocation(), NavigationRecomputeDistance);
+		NavigationField.Tick();
+	}
+
+	Super::GatherAgentRewards_Implementation(OutRewards, AgentIds);
+}
+
 void UFPSCharacterTrainingEnvironment::GatherAgentReward_Implementation(float& OutReward, const int32 AgentId)
 {
 	OutReward = 0.0f;
@@ -25,29 +52,30 @@ void UFPSCharacterTrainingEnvironment::GatherAgentReward_Implementation(float& O
 
 	FVector CharacterLocation = Character->GetActorLocation();
 	FVector TargetLocation = TargetActor->GetActorLocation();
-	float CurrentDistance = FVector::Dist(CharacterLocation, TargetLocation);
+	bool bNavigationDistance = false;
+	float CurrentDistance = GetTargetDistance(CharacterLocation, TargetLocation, bNavigationDistance);
+
+	// Keep the individual terms so episode statistics can report their contributions
+	FFPSRewardTerms Terms;
 
 	// Check if agent reached the target
 	if (TargetActor->IsLocationWithinReach(CharacterLocation))
 	{
-		OutReward += ReachTargetReward;
-		UE_LOG(LogTemp, Log, TEXT("Agent %d reached target! Reward: %f"), AgentId, ReachTargetReward);
+		Terms[EFPSRewardTerm::ReachTarget] = ReachTargetReward;
+		FPS_LEARNING_LOG(Reward, Verbose, TEXT("Agent %d reached target! Reward: %f"), AgentId, ReachTargetReward);
 	}
 	else
 	{
 		// Distance-based reward (closer = better)
 		float MaxDistance = FVector::Dist(ResetCenter - ResetBounds, ResetCenter + ResetBounds);
 		float NormalizedDistance = FMath::Clamp(CurrentDistance / MaxDistance, 0.0f, 1.0f);
-		OutReward += (1.0f - NormalizedDistance) * DistanceRewardScale;
+		Terms[EFPSRewardTerm::Distance] = (1.0f - NormalizedDistance) * DistanceRewardScale;
 
-		// Movement towards target reward
-		if (PreviousDistances.Contains(AgentId))
+		// Movement towards target reward, skipped for the step where the distance metric changes
+		const FPreviousDistance* PreviousDistance = PreviousDistances.Find(AgentId);
+		if (PreviousDistance && PreviousDistance->bNavigation == bNavigationDistance && CurrentDistance < PreviousDistance->Distance)
 		{
-			float PreviousDistance = PreviousDistances[AgentId];
-			if (CurrentDistance < PreviousDistance)
-			{
-				OutReward += MovementTowardsTargetReward;
-			}
+			Terms[EFPSRewardTerm::MovementTowardsTarget] = MovementTowardsTargetReward;
 		}
 		
 		// Facing target reward - encourage agent to look at the target
@@ -58,14 +86,22 @@ void UFPSCharacterTrainingEnvironment::GatherAgentReward_Implementation(float& O
 		// DotProduct ranges from -1 (opposite direction) to 1 (same direction)
 		// Convert to 0-1 range and apply reward
 		float FacingAlignment = (DotProduct + 1.0f) * 0.5f;
-		OutReward += FacingAlignment * FacingTargetReward;
+		Terms[EFPSRewardTerm::FacingTarget] = FacingAlignment * FacingTargetReward;
 	}
 
 	// Time step penalty to encourage efficiency
-	OutReward += TimeStepPenalty;
+	Terms[EFPSRewardTerm::TimeStep] = TimeStepPenalty;
+
+	OutReward = Terms.Sum();
+	LastRewards.Add(AgentId, OutReward);
+
+	if (EpisodeStatistics)
+	{
+		EpisodeStatistics->AddStep(AgentId, Terms);
+	}
 
 	// Update previous distance for next step
-	PreviousDistances.Add(AgentId, CurrentDistance);
+	PreviousDistances.Add(AgentId, { CurrentDistance, bNavigationDistance });
 
 	// Increment episode step counter
 	if (EpisodeSteps.Contains(AgentId))
@@ -86,17 +122,19 @@ void UFPSCharacterTrainingEnvironment::GatherAgentCompletion_Implementation(ELea
 	AFPSCharacter* Character = Cast<AFPSCharacter>(Manager->GetAgent(AgentId, AFPSCharacter::StaticClass()));
 	if (!Character || !TargetActor)
 	{
-		UE_LOG(LogTemp, Error, TEXT("Agent %d: Completion check failed - Character: %s, Target: %s"), 
+		FPS_LEARNING_LOG(Completion, Error, TEXT("Agent %d: Completion check failed - Character: %s, Target: %s"), 
 			AgentId, Character ? TEXT("Valid") : TEXT("NULL"), TargetActor ? TEXT("Valid") : TEXT("NULL"));
 		OutCompletion = ELearningAgentsCompletion::Termination;
+		RecordTermination(AgentId, EFPSEpisodeTermination::InvalidAgent);
 		return;
 	}
 
 	// Check if agent reached the target
 	if (TargetActor->IsLocationWithinReach(Character->GetActorLocation()))
 	{
-		UE_LOG(LogTemp, Log, TEXT("Agent %d (%s): Episode complete - reached target"), AgentId, *Character->GetName());
+		FPS_LEARNING_LOG(Completion, Verbose, TEXT("Agent %d (%s): Episode complete - reached target"), AgentId, *Character->GetName());
 		OutCompletion = ELearningAgentsCompletion::Termination;
+		RecordTermination(AgentId, EFPSEpisodeTermination::ReachedTarget);
 		return;
 	}
 
@@ -104,9 +142,10 @@ void UFPSCharacterTrainingEnvironment::GatherAgentCompletion_Implementation(ELea
 	int32 CurrentSteps = EpisodeSteps.FindRef(AgentId);
 	if (CurrentSteps >= (int32)MaxEpisodeLength)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Agent %d (%s): Episode complete - max steps reached (%d)"), 
+		FPS_LEARNING_LOG(Completion, Verbose, TEXT("Agent %d (%s): Episode complete - max steps reached (%d)"), 
 			AgentId, *Character->GetName(), CurrentSteps);
 		OutCompletion = ELearningAgentsCompletion::Termination;
+		RecordTermination(AgentId, EFPSEpisodeTermination::MaxSteps);
 		return;
 	}
 
@@ -118,8 +157,9 @@ void UFPSCharacterTrainingEnvironment::GatherAgentCompletion_Implementation(ELea
 	if (CharacterLocation.X < BoundsMin.X || CharacterLocation.X > BoundsMax.X ||
 		CharacterLocation.Y < BoundsMin.Y || CharacterLocation.Y > BoundsMax.Y)
 	{
-		UE_LOG(LogTemp, Log, TEXT("Agent %d (%s): Episode complete - out of bounds"), AgentId, *Character->GetName());
+		FPS_LEARNING_LOG(Completion, Verbose, TEXT("Agent %d (%s): Episode complete - out of bounds"), AgentId, *Character->GetName());
 		OutCompletion = ELearningAgentsCompletion::Termination;
+		RecordTermination(AgentId, EFPSEpisodeTermination::OutOfBounds);
 		return;
 	}
 }
@@ -130,7 +170,7 @@ void UFPSCharacterTrainingEnvironment::ResetAgentEpisode_Implementation(const in
 	AFPSCharacter* Character = Cast<AFPSCharacter>(Manager->GetAgent(AgentId, AFPSCharacter::StaticClass()));
 	if (!Character || !TargetActor)
 	{
-		UE_LOG(LogTemp, Error, TEXT("FPSCharacterTrainingEnvironment: Reset failed for Agent %d - Character: %s, Target: %s"), 
+		FPS_LEARNING_LOG(Reset, Error, TEXT("FPSCharacterTrainingEnvironment: Reset failed for Agent %d - Character: %s, Target: %s"), 
 			AgentId, 
 			Character ? TEXT("Valid") : TEXT("NULL"), 
 			TargetActor ? TEXT("Valid") : TEXT("NULL"));
@@ -141,6 +181,11 @@ void UFPSCharacterTrainingEnvironment::ResetAgentEpisode_Implementation(const in
 	EpisodeSteps.Add(AgentId, 0);
 	PreviousDistances.Remove(AgentId);
 
+	if (EpisodeStatistics)
+	{
+		EpisodeStatistics->BeginEpisode(AgentId);
+	}
+
 	// Reset character to random position with proper Z offset to avoid floor clipping
 	FVector CharacterResetLocation;
 	CharacterResetLocation.X = ResetCenter.X + FMath::RandRange(-ResetBounds.X, ResetBounds.X);
@@ -206,12 +251,57 @@ void UFPSCharacterTrainingEnvironment::ResetAgentEpisode_Implementation(const in
 
 		TargetActor->SetActorLocation(TargetResetLocation);
 		
-		UE_LOG(LogTemp, Log, TEXT("Reset Target for Agent %d - Target: %s"), AgentId, *TargetResetLocation.ToString());
+		FPS_LEARNING_LOG(Reset, Verbose, TEXT("Reset Target for Agent %d - Target: %s"), AgentId, *TargetResetLocation.ToString());
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("Reset Agent %d (%s) - Character: %s, Distance to Target: %f"), 
+	FPS_LEARNING_LOG(Reset, Verbose, TEXT("Reset Agent %d (%s) - Character: %s, Distance to Target: %f"), 
 		AgentId, 
 		*Character->GetName(),
 		*CharacterResetLocation.ToString(),
 		FVector::Dist(CharacterResetLocation, TargetActor->GetActorLocation()));
-} 
\ No newline at end of file
+}
+
+float UFPSCharacterTrainingEnvironment::GetTargetDistance(const FVector& CharacterLocation, const FVector& TargetLocation, bool& bOutNavigation) const
+{
+	float NavigationDistance = 0.0f;
+	bOutNavigation = bUseNavigationDistance && NavigationField.Sample(CharacterLocation, TargetLocation, NavigationRecomputeDistance, NavigationDistance);
+	if (bOutNavigation)
+	{
+		return NavigationDistance;
+	}
+	return FVector::Dist(CharacterLocation, TargetLocation);
+}
+
+void UFPSCharacterTrainingEnvironment::GetAgentEpisodeState(const int32 AgentId, FFPSAgentEpisodeState& OutState) const
+{
+	OutState.EpisodeStep = EpisodeSteps.FindRef(AgentId);
+	OutState.LastReward = LastRewards.FindRef(AgentId);
+
+	const FPreviousDistance* PreviousDistance = PreviousDistances.Find(AgentId);
+	OutState.bHasPreviousDistance = PreviousDistance != nullptr;
+	OutState.PreviousDistance = PreviousDistance ? PreviousDistance->Distance : 0.0f;
+	OutState.bPreviousDistanceIsNavigation = PreviousDistance ? PreviousDistance->bNavigation : false;
+}
+
+void UFPSCharacterTrainingEnvironment::SetAgentEpisodeState(const int32 AgentId, const FFPSAgentEpisodeState& State)
+{
+	EpisodeSteps.Add(AgentId, State.EpisodeStep);
+	LastRewards.Add(AgentId, State.LastReward);
+
+	if (State.bHasPreviousDistance)
+	{
+		PreviousDistances.Add(AgentId, { State.PreviousDistance, State.bPreviousDistanceIsNavigation });
+	}
+	else
+	{
+		PreviousDistances.Remove(AgentId);
+	}
+}
+
+void UFPSCharacterTrainingEnvironment::RecordTermination(const int32 AgentId, EFPSEpisodeTermination Termination)
+{
+	if (EpisodeStatistics)
+	{
+		EpisodeStatistics->EndEpisode(AgentId, Termination);
+	}
+}
@@ -4,6 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "LearningAgentsTrainingEnvironment.h"
+#include "FPSEpisodeStatistics.h"
+#include "FPSNavDistanceField.h"
+#include "FPSWorldSnapshot.h"
 #include "FPSCharacterTrainingEnvironment.generated.h"
 
 class AFPSTargetActor;
@@ -19,6 +22,7 @@ class FPSGAME_API UFPSCharacterTrainingEnvironment : public ULearningAgentsTrain
 public:
 	UFPSCharacterTrainingEnvironment();
 
+	virtual void GatherAgentRewards_Implementation(TArray<float>& OutRewards, const TArray<int32>& AgentIds) override;
 	virtual void GatherAgentReward_Implementation(float& OutReward, const int32 AgentId) override;
 	virtual void GatherAgentCompletion_Implementation(ELearningAgentsCompletion& OutCompletion, const int32 AgentId) override;
 	virtual void ResetAgentEpisode_Implementation(const int32 AgentId) override;
@@ -46,6 +50,24 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rewards")
 	float MaxEpisodeLength = 1000.0f;
 
+	// Measure distance to the target along walkable space instead of in a straight line
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rewards|Navigation")
+	bool bUseNavigationDistance = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rewards|Navigation", meta = (ClampMin = "10"))
+	float NavigationCellSize = 100.0f;
+
+	// Obstacle probe height above ResetCenter and extra clearance around each cell
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rewards|Navigation")
+	float NavigationProbeHeight = 100.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rewards|Navigation", meta = (ClampMin = "0"))
+	float NavigationProbeRadius = 40.0f;
+
+	// The field is recomputed when the target moves further than this
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rewards|Navigation", meta = (ClampMin = "0"))
+	float NavigationRecomputeDistance = 50.0f;
+
 	// Reset bounds for character and target
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Environment")
 	FVector ResetCenter = FVector::ZeroVector;
@@ -60,8 +82,34 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Environment")
 	float GroundClearance = 200.0f;
 
+	// Optional episode statistics sink, owned by the manager
+	FFPSEpisodeStatistics* EpisodeStatistics = nullptr;
+
+	// Last reward given to the agent and steps taken in its current episode
+	float GetLastReward(const int32 AgentId) const { return LastRewards.FindRef(AgentId); }
+	int32 GetEpisodeStep(const int32 AgentId) const { return EpisodeSteps.FindRef(AgentId); }
+
+	// Episode bookkeeping for snapshots, see AFPSCharacterManager::CaptureSnapshot
+	void GetAgentEpisodeState(const int32 AgentId, FFPSAgentEpisodeState& OutState) const;
+	void SetAgentEpisodeState(const int32 AgentId, const FFPSAgentEpisodeState& State);
+
 private:
+	void RecordTermination(const int32 AgentId, EFPSEpisodeTermination Termination);
+
+	// Navigation distance when the field is ready for the current target, straight-line distance otherwise
+	float GetTargetDistance(const FVector& CharacterLocation, const FVector& TargetLocation, bool& bOutNavigation) const;
+
+	FFPSNavDistanceField NavigationField;
+
+	// Distance at the previous step and which metric measured it, only comparable to a distance of the same metric
+	struct FPreviousDistance
+	{
+		float Distance = 0.0f;
+		bool bNavigation = false;
+	};
+
 	// Store previous distances for reward calculation
-	TMap<int32, float> PreviousDistances;
+	TMap<int32, FPreviousDistance> PreviousDistances;
 	TMap<int32, int32> EpisodeSteps;
+	TMap<int32, float> LastRewards;
 }; 
\ No newline at end of file
@@ -0,0 +1,336 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSEpisodeRecorder.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace FPSEpisodeRecording
+{
+	static const uint32 Magic = 0x52535046; // "FPSR"
+	static const uint8 Version = 1;
+
+	enum class EFrameType : uint8
+	{
+		Keyframe,
+		Delta
+	};
+
+	static const float LocationScale = 1.0f;
+	static const float AngleScale = 100.0f;
+	static const float ActionScale = 127.0f;
+	static const float RewardScale = 1000.0f;
+	static const float TimeScale = 1000.0f;
+
+	// Time, target X/Y/Z
+	static const int32 FrameFieldNum = 4;
+	// Id, X/Y/Z, yaw, pitch, 4 actions, reward, episode step
+	static const int32 AgentFieldNum = 12;
+
+	static uint32 ZigZag(int32 Value)
+	{
+		return ((uint32)Value << 1) ^ (uint32)(Value >> 31);
+	}
+
+	static int32 UnZigZag(uint32 Value)
+	{
+		return (int32)(Value >> 1) ^ -(int32)(Value & 1);
+	}
+
+	static void WriteVarUInt(TArray<uint8>& Out, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add((uint8)(Value | 0x80));
+			Value >>= 7;
+		}
+		Out.Add((uint8)Value);
+	}
+
+	static bool ReadVarUInt(const TArray<uint8>& In, int32& InOutOffset, uint32& OutValue)
+	{
+		OutValue = 0;
+		for (int32 Shift = 0; Shift < 35; Shift += 7)
+		{
+			if (InOutOffset >= In.Num())
+			{
+				return false;
+			}
+			const uint8 Byte = In[InOutOffset++];
+			OutValue |= (uint32)(Byte & 0x7F) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static int32 Quantize(float Value, float Scale)
+	{
+		return FMath::RoundToInt(Value * Scale);
+	}
+
+	static void Encode(const FFPSRecordedFrame& Frame, TArray<int32>& OutValues)
+	{
+		OutValues.Reset(FrameFieldNum + AgentFieldNum * Frame.Agents.Num());
+		OutValues.Add(Quantize(Frame.Time, TimeScale));
+		OutValues.Add(Quantize(Frame.TargetLocation.X, LocationScale));
+		OutValues.Add(Quantize(Frame.TargetLocation.Y, LocationScale));
+		OutValues.Add(Quantize(Frame.TargetLocation.Z, LocationScale));
+
+		for (const FFPSRecordedAgent& Agent : Frame.Agents)
+		{
+			OutValues.Add(Agent.AgentId);
+			OutValues.Add(Quantize(Agent.Location.X, LocationScale));
+			OutValues.Add(Quantize(Agent.Location.Y, LocationScale));
+			OutValues.Add(Quantize(Agent.Location.Z, LocationScale));
+			OutValues.Add(Quantize(FRotator::NormalizeAxis(Agent.Yaw), AngleScale));
+			OutValues.Add(Quantize(FRotator::NormalizeAxis(Agent.Pitch), AngleScale));
+			OutValues.Add(Quantize(FMath::Clamp(Agent.Actions.X, -1.0f, 1.0f), ActionScale));
+			OutValues.Add(Quantize(FMath::Clamp(Agent.Actions.Y, -1.0f, 1.0f), ActionScale));
+			OutValues.Add(Quantize(FMath::Clamp(Agent.Actions.Z, -1.0f, 1.0f), ActionScale));
+			OutValues.Add(Quantize(FMath::Clamp(Agent.Actions.W, -1.0f, 1.0f), ActionScale));
+			OutValues.Add(Quantize(Agent.Reward, RewardScale));
+			OutValues.Add(Agent.EpisodeStep);
+		}
+	}
+
+	static void Decode(const TArray<int32>& Values, FFPSRecordedFrame& OutFrame)
+	{
+		OutFrame.Time = Values[0] / TimeScale;
+		OutFrame.TargetLocation = FVector(Values[1], Values[2], Values[3]) / LocationScale;
+
+		const int32 AgentNum = (Values.Num() - FrameFieldNum) / AgentFieldNum;
+		OutFrame.Agents.SetNum(AgentNum);
+		for (int32 AgentIdx = 0; AgentIdx < AgentNum; AgentIdx++)
+		{
+			const int32* Fields = Values.GetData() + FrameFieldNum + AgentIdx * AgentFieldNum;
+			FFPSRecordedAgent& Agent = OutFrame.Agents[AgentIdx];
+			Agent.AgentId = Fields[0];
+			Agent.Location = FVector(Fields[1], Fields[2], Fields[3]) / LocationScale;
+			Agent.Yaw = Fields[4] / AngleScale;
+			Agent.Pitch = Fields[5] / AngleScale;
+			Agent.Actions = FVector4f(Fields[6], Fields[7], Fields[8], Fields[9]) / ActionScale;
+			Agent.Reward = Fields[10] / RewardScale;
+			Agent.EpisodeStep = Fields[11];
+		}
+	}
+}
+
+FFPSEpisodeRecorder::~FFPSEpisodeRecorder()
+{
+	End();
+}
+
+bool FFPSEpisodeRecorder::Begin(const FString& InFilePath, int32 InKeyframeInterval)
+{
+	using namespace FPSEpisodeRecording;
+
+	End();
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(InFilePath), true);
+
+	Buffer.Reset();
+	Buffer.Append((const uint8*)&Magic, sizeof(Magic));
+	Buffer.Add(Version);
+	if (!FFileHelper::SaveArrayToFile(Buffer, *InFilePath))
+	{
+		return false;
+	}
+
+	FilePath = InFilePath;
+	KeyframeInterval = FMath::Max(InKeyframeInterval, 1);
+	FrameNum = 0;
+	BytesWritten = Buffer.Num();
+	PreviousValues.Reset();
+	Buffer.Reset();
+	return true;
+}
+
+void FFPSEpisodeRecorder::AddFrame(const FFPSRecordedFrame& Frame)
+{
+	using namespace FPSEpisodeRecording;
+
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	Encode(Frame, Values);
+
+	const bool bKeyframe = FrameNum % KeyframeInterval == 0 || Values.Num() != PreviousValues.Num();
+	if (bKeyframe)
+	{
+		// Write what we have so a crash loses at most one keyframe interval
+		FlushBuffer();
+	}
+
+	Buffer.Add((uint8)(bKeyframe ? EFrameType::Keyframe : EFrameType::Delta));
+	WriteVarUInt(Buffer, Values.Num());
+	for (int32 ValueIdx = 0; ValueIdx < Values.Num(); ValueIdx++)
+	{
+		WriteVarUInt(Buffer, ZigZag(bKeyframe ? Values[ValueIdx] : Values[ValueIdx] - PreviousValues[ValueIdx]));
+	}
+
+	Swap(Values, PreviousValues);
+	FrameNum++;
+}
+
+void FFPSEpisodeRecorder::End()
+{
+	if (IsRecording())
+	{
+		FlushBuffer();
+		FilePath.Reset();
+	}
+}
+
+void FFPSEpisodeRecorder::FlushBuffer()
+{
+	if (Buffer.Num() > 0 && FFileHelper::SaveArrayToFile(Buffer, *FilePath, &IFileManager::Get(), FILEWRITE_Append))
+	{
+		BytesWritten += Buffer.Num();
+	}
+	Buffer.Reset();
+}
+
+bool FFPSEpisodeRecording::Load(const FString& FilePath)
+{
+	using namespace FPSEpisodeRecording;
+
+	Data.Reset();
+	FrameOffsets.Reset();
+	FrameTimes.Reset();
+	Keyframes.Reset();
+	CachedFrame = INDEX_NONE;
+
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath))
+	{
+		return false;
+	}
+
+	uint32 FileMagic = 0;
+	if (Data.Num() < (int32)sizeof(Magic) + 1)
+	{
+		return false;
+	}
+	FMemory::Memcpy(&FileMagic, Data.GetData(), sizeof(Magic));
+	if (FileMagic != Magic || Data[sizeof(Magic)] != Version)
+	{
+		return false;
+	}
+
+	// Index the frames; decoding the time field alone still needs every value, so keep a running frame
+	int32 Offset = sizeof(Magic) + 1;
+	TArray<int32> Running;
+	while (Offset < Data.Num())
+	{
+		const int32 FrameOffset = Offset;
+		const EFrameType Type = (EFrameType)Data[Offset++];
+
+		uint32 ValueNum = 0;
+		if (!ReadVarUInt(Data, Offset, ValueNum) || (Type == EFrameType::Delta && (int32)ValueNum != Running.Num()))
+		{
+			// Truncated tail from an interrupted recording
+			break;
+		}
+		if (Type == EFrameType::Keyframe)
+		{
+			Running.SetNumZeroed(ValueNum);
+		}
+
+		bool bComplete = true;
+		for (uint32 ValueIdx = 0; ValueIdx < ValueNum; ValueIdx++)
+		{
+			uint32 Encoded = 0;
+			if (!ReadVarUInt(Data, Offset, Encoded))
+			{
+				bComplete = false;
+				break;
+			}
+			Running[ValueIdx] = (Type == EFrameType::Keyframe ? 0 : Running[ValueIdx]) + UnZigZag(Encoded);
+		}
+		if (!bComplete || Running.Num() < FrameFieldNum)
+		{
+			break;
+		}
+
+		if (Type == EFrameType::Keyframe)
+		{
+			Keyframes.Add(FrameOffsets.Num());
+		}
+		FrameOffsets.Add(FrameOffset);
+		FrameTimes.Add(Running[0] / TimeScale);
+	}
+
+	return FrameOffsets.Num() > 0;
+}
+
+int32 FFPSEpisodeRecording::FindFrame(float Time) const
+{
+	const int32 Upper = Algo::UpperBound(FrameTimes, Time);
+	return FMath::Clamp(Upper - 1, 0, FrameTimes.Num() - 1);
+}
+
+bool FFPSEpisodeRecording::GetFrame(int32 FrameIndex, FFPSRecordedFrame& OutFrame)
+{
+	if (!FrameOffsets.IsValidIndex(FrameIndex))
+	{
+		return false;
+	}
+
+	// Continue from the cache when it is in the same keyframe span, else restart from the keyframe
+	const int32 KeyframeIdx = Algo::UpperBound(Keyframes, FrameIndex) - 1;
+	const int32 Keyframe = Keyframes[KeyframeIdx];
+	int32 Start = Keyframe;
+	if (CachedFrame != INDEX_NONE && CachedFrame >= Keyframe && CachedFrame <= FrameIndex)
+	{
+		Start = CachedFrame + 1;
+	}
+	else
+	{
+		CachedValues.Reset();
+	}
+
+	for (int32 Index = Start; Index <= FrameIndex; Index++)
+	{
+		if (!DecodeInto(Index, CachedValues))
+		{
+			CachedFrame = INDEX_NONE;
+			return false;
+		}
+		CachedFrame = Index;
+	}
+
+	FPSEpisodeRecording::Decode(CachedValues, OutFrame);
+	return true;
+}
+
+bool FFPSEpisodeRecording::DecodeInto(int32 FrameIndex, TArray<int32>& InOutValues) const
+{
+	using namespace FPSEpisodeRecording;
+
+	int32 Offset = FrameOffsets[FrameIndex];
+	const EFrameType Type = (EFrameType)Data[Offset++];
+
+	uint32 ValueNum = 0;
+	ReadVarUInt(Data, Offset, ValueNum);
+	if (Type == EFrameType::Keyframe)
+	{
+		InOutValues.SetNumZeroed(ValueNum);
+	}
+	else if ((int32)ValueNum != InOutValues.Num())
+	{
+		return false;
+	}
+
+	for (uint32 ValueIdx = 0; ValueIdx < ValueNum; ValueIdx++)
+	{
+		uint32 Encoded = 0;
+		ReadVarUInt(Data, Offset, Encoded);
+		InOutValues[ValueIdx] = (Type == EFrameType::Keyframe ? 0 : InOutValues[ValueIdx]) + UnZigZag(Encoded);
+	}
+	return true;
+}
@@ -0,0 +1,88 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// One agent in one recorded step
+struct FFPSRecordedAgent
+{
+	int32 AgentId = INDEX_NONE;
+	FVector Location = FVector::ZeroVector;
+	float Yaw = 0.0f;
+	float Pitch = 0.0f;
+	// MoveForward, MoveRight, Turn, LookUp
+	FVector4f Actions = FVector4f(0.0f, 0.0f, 0.0f, 0.0f);
+	float Reward = 0.0f;
+	int32 EpisodeStep = 0;
+};
+
+struct FFPSRecordedFrame
+{
+	float Time = 0.0f;
+	FVector TargetLocation = FVector::ZeroVector;
+	TArray<FFPSRecordedAgent> Agents;
+};
+
+/**
+ * Compact learning episode stream. Each frame is quantized to a vector of integers (centimetres, hundredths of
+ * a degree, actions in 1/127 steps, rewards in thousandths) and stored as zigzag varints: absolute values in
+ * keyframes, differences to the previous frame otherwise. A keyframe is written every KeyframeInterval frames
+ * and whenever the agent count changes, so readers can seek without decoding from the start.
+ */
+class FPSGAME_API FFPSEpisodeRecorder
+{
+public:
+	~FFPSEpisodeRecorder();
+
+	bool Begin(const FString& InFilePath, int32 InKeyframeInterval = 60);
+	void AddFrame(const FFPSRecordedFrame& Frame);
+	void End();
+
+	bool IsRecording() const { return !FilePath.IsEmpty(); }
+	int32 GetFrameNum() const { return FrameNum; }
+	int64 GetBytesWritten() const { return BytesWritten; }
+
+private:
+	void FlushBuffer();
+
+	FString FilePath;
+	int32 KeyframeInterval = 60;
+	int32 FrameNum = 0;
+	int64 BytesWritten = 0;
+
+	TArray<int32> Values;
+	TArray<int32> PreviousValues;
+	TArray<uint8> Buffer;
+};
+
+/**
+ * Loads a recording into memory in its encoded form and decodes frames on demand. Sequential access decodes one
+ * delta per frame; random access starts from the nearest keyframe.
+ */
+class FPSGAME_API FFPSEpisodeRecording
+{
+public:
+	bool Load(const FString& FilePath);
+
+	int32 GetFrameNum() const { return FrameOffsets.Num(); }
+	float GetFrameTime(int32 FrameIndex) const { return FrameTimes[FrameIndex]; }
+	float GetDuration() const { return FrameTimes.Num() > 0 ? FrameTimes.Last() : 0.0f; }
+
+	// Last frame at or before Time
+	int32 FindFrame(float Time) const;
+
+	bool GetFrame(int32 FrameIndex, FFPSRecordedFrame& OutFrame);
+
+private:
+	bool DecodeInto(int32 FrameIndex, TArray<int32>& InOutValues) const;
+
+	TArray<uint8> Data;
+	TArray<int32> FrameOffsets;
+	TArray<float> FrameTimes;
+	TArray<int32> Keyframes;
+
+	// Last decoded frame, so playing forward only decodes deltas
+	int32 CachedFrame = INDEX_NONE;
+	TArray<int32> CachedValues;
+};
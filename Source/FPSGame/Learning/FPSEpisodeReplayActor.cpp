@@ -0,0 +1,303 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSEpisodeReplayActor.h"
+#include "FPSCharacter.h"
+#include "FPSTargetActor.h"
+#include "DrawDebugHelpers.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+namespace FPSEpisodeReplay
+{
+	static void ForEachReplayActor(UWorld* World, TFunctionRef<void(AFPSEpisodeReplayActor*)> Func)
+	{
+		for (TActorIterator<AFPSEpisodeReplayActor> It(World); It; ++It)
+		{
+			Func(*It);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorld PlayCommand(TEXT("FPS.Replay.Play"), TEXT("Resumes episode replay."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			ForEachReplayActor(World, [](AFPSEpisodeReplayActor* Actor) { Actor->Play(); });
+		}));
+
+	static FAutoConsoleCommandWithWorld PauseCommand(TEXT("FPS.Replay.Pause"), TEXT("Pauses episode replay."),
+		FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+		{
+			ForEachReplayActor(World, [](AFPSEpisodeReplayActor* Actor) { Actor->Pause(); });
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs RateCommand(TEXT("FPS.Replay.Rate"), TEXT("FPS.Replay.Rate <multiplier>"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			const float Rate = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 1.0f;
+			ForEachReplayActor(World, [Rate](AFPSEpisodeReplayActor* Actor) { Actor->SetPlaybackRate(Rate); });
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs SeekCommand(TEXT("FPS.Replay.Seek"), TEXT("FPS.Replay.Seek <seconds>"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			const float Time = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 0.0f;
+			ForEachReplayActor(World, [Time](AFPSEpisodeReplayActor* Actor) { Actor->SeekToTime(Time); });
+		}));
+
+	static FAutoConsoleCommandWithWorldAndArgs StepCommand(TEXT("FPS.Replay.Step"), TEXT("FPS.Replay.Step <frames>"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			const int32 Frames = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1;
+			ForEachReplayActor(World, [Frames](AFPSEpisodeReplayActor* Actor) { Actor->StepFrames(Frames); });
+		}));
+}
+
+AFPSEpisodeReplayActor::AFPSEpisodeReplayActor()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bTickEvenWhenPaused = true;
+
+	GhostClass = AFPSCharacter::StaticClass();
+	TargetGhostClass = AFPSTargetActor::StaticClass();
+}
+
+void AFPSEpisodeReplayActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	FString FilePath = RecordingFile.FilePath;
+	FParse::Value(FCommandLine::Get(), TEXT("FPSReplay="), FilePath);
+
+	if (!FilePath.IsEmpty() && LoadRecording(FilePath) && bAutoPlay)
+	{
+		Play();
+	}
+}
+
+void AFPSEpisodeReplayActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (const TPair<int32, AActor*>& Ghost : Ghosts)
+	{
+		if (IsValid(Ghost.Value))
+		{
+			Ghost.Value->Destroy();
+		}
+	}
+	Ghosts.Reset();
+
+	if (IsValid(TargetGhost))
+	{
+		TargetGhost->Destroy();
+	}
+	TargetGhost = nullptr;
+
+	Super::EndPlay(EndPlayReason);
+}
+
+bool AFPSEpisodeReplayActor::LoadRecording(const FString& FilePath)
+{
+	const FString FullPath = FPaths::IsRelative(FilePath) ? FPaths::ProjectDir() / FilePath : FilePath;
+	if (!Recording.Load(FullPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FPSEpisodeReplayActor: Failed to load recording %s"), *FullPath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("FPSEpisodeReplayActor: Loaded %s - %d frames, %.1f seconds"), *FullPath, Recording.GetFrameNum(), GetDuration());
+
+	LoadedFrame = INDEX_NONE;
+	SeekToTime(0.0f);
+	return true;
+}
+
+void AFPSEpisodeReplayActor::Play()
+{
+	bPlaying = Recording.GetFrameNum() > 0;
+}
+
+void AFPSEpisodeReplayActor::Pause()
+{
+	bPlaying = false;
+}
+
+void AFPSEpisodeReplayActor::SetPlaybackRate(float Rate)
+{
+	PlaybackRate = Rate;
+}
+
+void AFPSEpisodeReplayActor::SeekToTime(float Time)
+{
+	if (Recording.GetFrameNum() == 0)
+	{
+		return;
+	}
+
+	PlaybackTime = FMath::Clamp(Time, Recording.GetFrameTime(0), GetDuration());
+	ApplyTime(PlaybackTime);
+}
+
+void AFPSEpisodeReplayActor::StepFrames(int32 FrameDelta)
+{
+	if (Recording.GetFrameNum() == 0)
+	{
+		return;
+	}
+
+	const int32 Frame = FMath::Clamp(Recording.FindFrame(PlaybackTime) + FrameDelta, 0, Recording.GetFrameNum() - 1);
+	SeekToTime(Recording.GetFrameTime(Frame));
+}
+
+float AFPSEpisodeReplayActor::GetDuration() const
+{
+	return Recording.GetDuration();
+}
+
+void AFPSEpisodeReplayActor::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bPlaying || Recording.GetFrameNum() == 0)
+	{
+		return;
+	}
+
+	float Time = PlaybackTime + DeltaTime * PlaybackRate;
+	const float StartTime = Recording.GetFrameTime(0);
+	if (Time > GetDuration() || Time < StartTime)
+	{
+		if (bLoop)
+		{
+			Time = Time > GetDuration() ? StartTime : GetDuration();
+		}
+		else
+		{
+			bPlaying = false;
+		}
+	}
+
+	SeekToTime(Time);
+}
+
+void AFPSEpisodeReplayActor::ApplyTime(float Time)
+{
+	const int32 Frame = Recording.FindFrame(Time);
+	const bool bHasNext = Frame + 1 < Recording.GetFrameNum();
+
+	// Playing forward slides the window along so only one new frame is decoded per recorded step
+	if (Frame != LoadedFrame)
+	{
+		if (Frame == LoadedFrame + 1 && bHasNext)
+		{
+			Swap(FrameA, FrameB);
+			Recording.GetFrame(Frame + 1, FrameB);
+		}
+		else
+		{
+			Recording.GetFrame(Frame, FrameA);
+			if (bHasNext)
+			{
+				Recording.GetFrame(Frame + 1, FrameB);
+			}
+		}
+		LoadedFrame = Frame;
+	}
+
+	const float TimeA = Recording.GetFrameTime(Frame);
+	const float TimeB = bHasNext ? Recording.GetFrameTime(Frame + 1) : TimeA;
+	const float Alpha = TimeB > TimeA ? FMath::Clamp((Time - TimeA) / (TimeB - TimeA), 0.0f, 1.0f) : 0.0f;
+
+	if (!TargetGhost && TargetGhostClass)
+	{
+		TargetGhost = SpawnGhost(TargetGhostClass);
+	}
+	if (TargetGhost)
+	{
+		const bool bTargetMoved = bHasNext && FVector::DistSquared(FrameA.TargetLocation, FrameB.TargetLocation) > FMath::Square(100.0f);
+		TargetGhost->SetActorLocation(bHasNext && !bTargetMoved ? FMath::Lerp(FrameA.TargetLocation, FrameB.TargetLocation, Alpha) : FrameA.TargetLocation);
+	}
+
+	TSet<int32> SeenAgents;
+	for (int32 AgentIdx = 0; AgentIdx < FrameA.Agents.Num(); AgentIdx++)
+	{
+		const FFPSRecordedAgent& AgentA = FrameA.Agents[AgentIdx];
+		SeenAgents.Add(AgentA.AgentId);
+
+		AActor* Ghost = GetGhost(AgentA.AgentId);
+		if (!Ghost)
+		{
+			continue;
+		}
+
+		// Interpolate within an episode, snap across resets
+		FVector Location = AgentA.Location;
+		float Yaw = AgentA.Yaw;
+		if (bHasNext && FrameB.Agents.IsValidIndex(AgentIdx))
+		{
+			const FFPSRecordedAgent& AgentB = FrameB.Agents[AgentIdx];
+			if (AgentB.AgentId == AgentA.AgentId && AgentB.EpisodeStep > AgentA.EpisodeStep)
+			{
+				Location = FMath::Lerp(AgentA.Location, AgentB.Location, Alpha);
+				Yaw = AgentA.Yaw + Alpha * FRotator::NormalizeAxis(AgentB.Yaw - AgentA.Yaw);
+			}
+		}
+
+		Ghost->SetActorHiddenInGame(false);
+		Ghost->SetActorLocationAndRotation(Location, FRotator(0.0f, Yaw, 0.0f));
+
+		if (bDrawActions)
+		{
+			const FRotator Facing(0.0f, Yaw, 0.0f);
+			const FVector Movement = Facing.RotateVector(FVector(AgentA.Actions.X, AgentA.Actions.Y, 0.0f));
+			DrawDebugDirectionalArrow(GetWorld(), Location, Location + Movement * 150.0f, 30.0f, FColor::Cyan, false, -1.0f, 0, 3.0f);
+			DrawDebugLine(GetWorld(), Location, Location + FRotator(AgentA.Pitch, Yaw, 0.0f).Vector() * 100.0f, FColor::Yellow, false, -1.0f, 0, 1.0f);
+			DrawDebugString(GetWorld(), Location + FVector(0.0f, 0.0f, 120.0f),
+				FString::Printf(TEXT("%d  step %d  r %.2f"), AgentA.AgentId, AgentA.EpisodeStep, AgentA.Reward), nullptr, FColor::White, 0.0f);
+		}
+	}
+
+	// Agents missing from this frame
+	for (const TPair<int32, AActor*>& Ghost : Ghosts)
+	{
+		if (!SeenAgents.Contains(Ghost.Key) && IsValid(Ghost.Value))
+		{
+			Ghost.Value->SetActorHiddenInGame(true);
+		}
+	}
+}
+
+AActor* AFPSEpisodeReplayActor::GetGhost(int32 AgentId)
+{
+	if (AActor** Existing = Ghosts.Find(AgentId))
+	{
+		return *Existing;
+	}
+
+	AActor* Ghost = GhostClass ? SpawnGhost(GhostClass) : nullptr;
+	Ghosts.Add(AgentId, Ghost);
+	return Ghost;
+}
+
+AActor* AFPSEpisodeReplayActor::SpawnGhost(TSubclassOf<AActor> Class)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = this;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AActor* Ghost = GetWorld()->SpawnActor<AActor>(Class, GetActorTransform(), SpawnParams);
+	if (!Ghost)
+	{
+		return nullptr;
+	}
+
+	// Pure visuals: nothing simulates, collides or thinks
+	Ghost->SetActorEnableCollision(false);
+	Ghost->SetActorTickEnabled(false);
+	TInlineComponentArray<UActorComponent*> Components(Ghost);
+	for (UActorComponent* Component : Components)
+	{
+		Component->SetComponentTickEnabled(false);
+	}
+	return Ghost;
+}
@@ -0,0 +1,97 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/EngineTypes.h"
+#include "FPSEpisodeRecorder.h"
+#include "FPSEpisodeReplayActor.generated.h"
+
+/**
+ * Plays back an episode recording made by AFPSCharacterManager with ghost pawns, at any speed and with scrubbing.
+ * Drop one into a viewer map; it loads RecordingFile (or -FPSReplay=<file>) on BeginPlay.
+ * Console: FPS.Replay.Play, FPS.Replay.Pause, FPS.Replay.Rate <x>, FPS.Replay.Seek <seconds>, FPS.Replay.Step <frames>
+ */
+UCLASS()
+class FPSGAME_API AFPSEpisodeReplayActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AFPSEpisodeReplayActor();
+
+	virtual void Tick(float DeltaTime) override;
+
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	bool LoadRecording(const FString& FilePath);
+
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	void Play();
+
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	void Pause();
+
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	void SetPlaybackRate(float Rate);
+
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	void SeekToTime(float Time);
+
+	// Moves by whole recorded steps, e.g. for frame-by-frame inspection while paused
+	UFUNCTION(BlueprintCallable, Category = "Replay")
+	void StepFrames(int32 FrameDelta);
+
+	UFUNCTION(BlueprintPure, Category = "Replay")
+	float GetDuration() const;
+
+	UFUNCTION(BlueprintPure, Category = "Replay")
+	float GetPlaybackTime() const { return PlaybackTime; }
+
+	UPROPERTY(EditAnywhere, Category = "Replay", meta = (FilePathFilter = "fpsrec"))
+	FFilePath RecordingFile;
+
+	UPROPERTY(EditAnywhere, Category = "Replay")
+	float PlaybackRate = 1.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Replay")
+	bool bAutoPlay = true;
+
+	UPROPERTY(EditAnywhere, Category = "Replay")
+	bool bLoop = true;
+
+	// Spawned once per recorded agent, with collision and ticking disabled
+	UPROPERTY(EditAnywhere, Category = "Replay")
+	TSubclassOf<AActor> GhostClass;
+
+	UPROPERTY(EditAnywhere, Category = "Replay")
+	TSubclassOf<AActor> TargetGhostClass;
+
+	// Draw each agent's movement action and last reward
+	UPROPERTY(EditAnywhere, Category = "Replay")
+	bool bDrawActions = true;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	void ApplyTime(float Time);
+	AActor* GetGhost(int32 AgentId);
+	AActor* SpawnGhost(TSubclassOf<AActor> Class);
+
+	FFPSEpisodeRecording Recording;
+
+	// Frames around the playback time, FrameA is LoadedFrame
+	FFPSRecordedFrame FrameA;
+	FFPSRecordedFrame FrameB;
+	int32 LoadedFrame = INDEX_NONE;
+
+	UPROPERTY()
+	TMap<int32, AActor*> Ghosts;
+
+	UPROPERTY()
+	AActor* TargetGhost = nullptr;
+
+	float PlaybackTime = 0.0f;
+	bool bPlaying = false;
+};
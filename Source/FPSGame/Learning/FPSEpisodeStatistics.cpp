@@ -0,0 +1,208 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSEpisodeStatistics.h"
+
+float FFPSRewardTerms::Sum() const
+{
+	float Total = 0.0f;
+	for (const float Value : Values)
+	{
+		Total += Value;
+	}
+	return Total;
+}
+
+void FFPSRewardTerms::Accumulate(const FFPSRewardTerms& Other)
+{
+	for (int32 TermIdx = 0; TermIdx < (int32)EFPSRewardTerm::Num; TermIdx++)
+	{
+		Values[TermIdx] += Other.Values[TermIdx];
+	}
+}
+
+void FFPSHistogram::Build(TConstArrayView<float> Values, int32 BinNum)
+{
+	*this = FFPSHistogram();
+	Num = Values.Num();
+	if (Num == 0)
+	{
+		return;
+	}
+
+	Min = Max = Values[0];
+	for (const float Value : Values)
+	{
+		Min = FMath::Min<double>(Min, Value);
+		Max = FMath::Max<double>(Max, Value);
+		Sum += Value;
+		SumSquares += (double)Value * Value;
+	}
+
+	BinNum = FMath::Max(BinNum, 1);
+	const double BinWidth = FMath::Max((Max - Min) / BinNum, UE_DOUBLE_SMALL_NUMBER);
+
+	BucketLimits.SetNumUninitialized(BinNum);
+	BucketCounts.SetNumZeroed(BinNum);
+	for (int32 BinIdx = 0; BinIdx < BinNum; BinIdx++)
+	{
+		BucketLimits[BinIdx] = Min + BinWidth * (BinIdx + 1);
+	}
+
+	for (const float Value : Values)
+	{
+		const int32 BinIdx = FMath::Clamp((int32)((Value - Min) / BinWidth), 0, BinNum - 1);
+		BucketCounts[BinIdx]++;
+	}
+}
+
+TSharedRef<FJsonObject> FFPSHistogram::ToJson() const
+{
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("num"), Num);
+	Json->SetNumberField(TEXT("min"), Min);
+	Json->SetNumberField(TEXT("max"), Max);
+	Json->SetNumberField(TEXT("mean"), Mean());
+
+	TArray<TSharedPtr<FJsonValue>> Limits;
+	TArray<TSharedPtr<FJsonValue>> Counts;
+	for (int32 BinIdx = 0; BinIdx < BucketCounts.Num(); BinIdx++)
+	{
+		Limits.Add(MakeShared<FJsonValueNumber>(BucketLimits[BinIdx]));
+		Counts.Add(MakeShared<FJsonValueNumber>(BucketCounts[BinIdx]));
+	}
+	Json->SetArrayField(TEXT("bucket_limits"), Limits);
+	Json->SetArrayField(TEXT("bucket_counts"), Counts);
+	return Json;
+}
+
+TSharedRef<FJsonObject> FFPSEpisodeSummary::ToJson() const
+{
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("episodes"), Episodes);
+	Json->SetNumberField(TEXT("steps"), (double)Steps);
+	Json->SetNumberField(TEXT("success_rate"), SuccessRate());
+	Json->SetObjectField(TEXT("return"), Return.ToJson());
+	Json->SetObjectField(TEXT("length"), Length.ToJson());
+
+	TSharedRef<FJsonObject> TermsJson = MakeShared<FJsonObject>();
+	for (int32 TermIdx = 0; TermIdx < (int32)EFPSRewardTerm::Num; TermIdx++)
+	{
+		TermsJson->SetNumberField(FFPSEpisodeStatistics::GetRewardTermName((EFPSRewardTerm)TermIdx), MeanTerms.Values[TermIdx]);
+	}
+	Json->SetObjectField(TEXT("mean_reward_terms"), TermsJson);
+
+	TSharedRef<FJsonObject> TerminationJson = MakeShared<FJsonObject>();
+	for (int32 ReasonIdx = 0; ReasonIdx < (int32)EFPSEpisodeTermination::Num; ReasonIdx++)
+	{
+		TerminationJson->SetNumberField(FFPSEpisodeStatistics::GetTerminationName((EFPSEpisodeTermination)ReasonIdx), TerminationCounts[ReasonIdx]);
+	}
+	Json->SetObjectField(TEXT("terminations"), TerminationJson);
+	return Json;
+}
+
+void FFPSEpisodeStatistics::Initialize(int32 MaxAgentNum)
+{
+	AgentEpisodes.Reset();
+	AgentEpisodes.SetNum(MaxAgentNum);
+
+	FFPSEpisodeRecord Discarded;
+	while (FinishedEpisodes.Dequeue(Discarded)) {}
+	StepCount.store(0, std::memory_order_relaxed);
+}
+
+void FFPSEpisodeStatistics::AddStep(int32 AgentId, const FFPSRewardTerms& Terms)
+{
+	if (!AgentEpisodes.IsValidIndex(AgentId))
+	{
+		return;
+	}
+
+	FAgentEpisode& Episode = AgentEpisodes[AgentId];
+	Episode.Terms.Accumulate(Terms);
+	Episode.Length++;
+	Episode.bOpen = true;
+	StepCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FFPSEpisodeStatistics::EndEpisode(int32 AgentId, EFPSEpisodeTermination Termination)
+{
+	if (!AgentEpisodes.IsValidIndex(AgentId) || !AgentEpisodes[AgentId].bOpen)
+	{
+		return;
+	}
+
+	FAgentEpisode& Episode = AgentEpisodes[AgentId];
+
+	FFPSEpisodeRecord Record;
+	Record.AgentId = AgentId;
+	Record.Length = Episode.Length;
+	Record.bSuccess = (Termination == EFPSEpisodeTermination::ReachedTarget);
+	Record.Termination = Termination;
+	Record.Terms = Episode.Terms;
+	FinishedEpisodes.Enqueue(Record);
+
+	Episode = FAgentEpisode();
+}
+
+void FFPSEpisodeStatistics::BeginEpisode(int32 AgentId)
+{
+	EndEpisode(AgentId, EFPSEpisodeTermination::Truncated);
+}
+
+void FFPSEpisodeStatistics::Summarize(FFPSEpisodeSummary& OutSummary, int32 HistogramBinNum)
+{
+	OutSummary = FFPSEpisodeSummary();
+
+	TArray<float> Returns;
+	TArray<float> Lengths;
+
+	FFPSEpisodeRecord Record;
+	while (FinishedEpisodes.Dequeue(Record))
+	{
+		OutSummary.Episodes++;
+		OutSummary.Successes += Record.bSuccess ? 1 : 0;
+		OutSummary.TerminationCounts[(int32)Record.Termination]++;
+		OutSummary.MeanTerms.Accumulate(Record.Terms);
+
+		Returns.Add(Record.Terms.Sum());
+		Lengths.Add((float)Record.Length);
+	}
+
+	if (OutSummary.Episodes > 0)
+	{
+		for (float& Value : OutSummary.MeanTerms.Values)
+		{
+			Value /= OutSummary.Episodes;
+		}
+	}
+
+	OutSummary.Return.Build(Returns, HistogramBinNum);
+	OutSummary.Length.Build(Lengths, HistogramBinNum);
+	OutSummary.Steps = StepCount.exchange(0, std::memory_order_relaxed);
+}
+
+const TCHAR* FFPSEpisodeStatistics::GetTerminationName(EFPSEpisodeTermination Termination)
+{
+	switch (Termination)
+	{
+	case EFPSEpisodeTermination::ReachedTarget:	return TEXT("reached_target");
+	case EFPSEpisodeTermination::MaxSteps:		return TEXT("max_steps");
+	case EFPSEpisodeTermination::OutOfBounds:	return TEXT("out_of_bounds");
+	case EFPSEpisodeTermination::InvalidAgent:	return TEXT("invalid_agent");
+	case EFPSEpisodeTermination::Truncated:		return TEXT("truncated");
+	default:									return TEXT("unknown");
+	}
+}
+
+const TCHAR* FFPSEpisodeStatistics::GetRewardTermName(EFPSRewardTerm Term)
+{
+	switch (Term)
+	{
+	case EFPSRewardTerm::ReachTarget:			return TEXT("reach_target");
+	case EFPSRewardTerm::Distance:				return TEXT("distance");
+	case EFPSRewardTerm::MovementTowardsTarget:	return TEXT("movement_towards_target");
+	case EFPSRewardTerm::FacingTarget:			return TEXT("facing_target");
+	case EFPSRewardTerm::TimeStep:				return TEXT("time_step");
+	default:									return TEXT("unknown");
+	}
+}
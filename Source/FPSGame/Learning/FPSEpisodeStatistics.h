@@ -0,0 +1,119 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Dom/JsonObject.h"
+#include <atomic>
+
+/** Why an episode ended */
+enum class EFPSEpisodeTermination : uint8
+{
+	ReachedTarget,
+	MaxSteps,
+	OutOfBounds,
+	InvalidAgent,
+	Truncated,		// Reset from outside (trainer episode limit, manual reset) without a completion
+	Num
+};
+
+/** Individual terms that make up the per-step reward */
+enum class EFPSRewardTerm : uint8
+{
+	ReachTarget,
+	Distance,
+	MovementTowardsTarget,
+	FacingTarget,
+	TimeStep,
+	Num
+};
+
+struct FFPSRewardTerms
+{
+	float Values[(int32)EFPSRewardTerm::Num] = {};
+
+	float& operator[](EFPSRewardTerm Term) { return Values[(int32)Term]; }
+	float operator[](EFPSRewardTerm Term) const { return Values[(int32)Term]; }
+
+	float Sum() const;
+	void Accumulate(const FFPSRewardTerms& Other);
+};
+
+struct FFPSEpisodeRecord
+{
+	int32 AgentId = INDEX_NONE;
+	int32 Length = 0;
+	bool bSuccess = false;
+	EFPSEpisodeTermination Termination = EFPSEpisodeTermination::Truncated;
+	FFPSRewardTerms Terms;
+};
+
+/** Fixed-bin histogram over the values seen in one reporting interval */
+struct FFPSHistogram
+{
+	double Min = 0.0;
+	double Max = 0.0;
+	double Sum = 0.0;
+	double SumSquares = 0.0;
+	int32 Num = 0;
+	TArray<double> BucketLimits;
+	TArray<int32> BucketCounts;
+
+	void Build(TConstArrayView<float> Values, int32 BinNum);
+	double Mean() const { return Num > 0 ? Sum / Num : 0.0; }
+	TSharedRef<FJsonObject> ToJson() const;
+};
+
+/** Everything gathered since the previous summary */
+struct FFPSEpisodeSummary
+{
+	int32 Episodes = 0;
+	int32 Successes = 0;
+	int64 Steps = 0;
+	FFPSHistogram Return;
+	FFPSHistogram Length;
+	FFPSRewardTerms MeanTerms;
+	int32 TerminationCounts[(int32)EFPSEpisodeTermination::Num] = {};
+
+	float SuccessRate() const { return Episodes > 0 ? (float)Successes / Episodes : 0.0f; }
+	TSharedRef<FJsonObject> ToJson() const;
+};
+
+/**
+ * Collects per-episode statistics from the training environment callbacks.
+ * Each agent slot is only written by the callbacks for that agent, finished episodes are pushed
+ * through a lock-free queue and drained by the manager when it emits a summary.
+ */
+class FFPSEpisodeStatistics
+{
+public:
+	void Initialize(int32 MaxAgentNum);
+
+	/** Adds one step worth of reward terms to the agent's running episode */
+	void AddStep(int32 AgentId, const FFPSRewardTerms& Terms);
+
+	/** Closes the agent's running episode */
+	void EndEpisode(int32 AgentId, EFPSEpisodeTermination Termination);
+
+	/** Starts a new episode, recording the previous one as truncated if it was never completed */
+	void BeginEpisode(int32 AgentId);
+
+	/** Drains finished episodes into a summary. Game thread only. */
+	void Summarize(FFPSEpisodeSummary& OutSummary, int32 HistogramBinNum);
+
+	static const TCHAR* GetTerminationName(EFPSEpisodeTermination Termination);
+	static const TCHAR* GetRewardTermName(EFPSRewardTerm Term);
+
+private:
+	struct FAgentEpisode
+	{
+		FFPSRewardTerms Terms;
+		int32 Length = 0;
+		bool bOpen = false;
+	};
+
+	TArray<FAgentEpisode> AgentEpisodes;
+	TQueue<FFPSEpisodeRecord, EQueueMode::Mpsc> FinishedEpisodes;
+	std::atomic<int64> StepCount{ 0 };
+};
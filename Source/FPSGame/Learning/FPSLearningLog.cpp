@@ -0,0 +1,201 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSLearningLog.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/OutputDeviceRedirector.h"
+
+DEFINE_LOG_CATEGORY(LogFPSLearning);
+
+static FAutoConsoleCommand CVarFlushLearningLog(
+	TEXT("FPS.Learning.FlushLog"),
+	TEXT("Writes the buffered learning log messages to the output log."),
+	FConsoleCommandDelegate::CreateLambda([]() { FFPSLearningLog::Get().Flush(); }));
+
+static FAutoConsoleCommand CVarLearningLogBudget(
+	TEXT("FPS.Learning.LogBudget"),
+	TEXT("FPS.Learning.LogBudget <Channel> <MessagesPerSecond>. Channels: Manager, Observation, Action, Reward, Completion, Reset."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() < 2)
+		{
+			return;
+		}
+
+		for (int32 ChannelIdx = 0; ChannelIdx < (int32)EFPSLearningLogChannel::Num; ChannelIdx++)
+		{
+			const EFPSLearningLogChannel Channel = (EFPSLearningLogChannel)ChannelIdx;
+			if (Args[0].Equals(FFPSLearningLog::GetChannelName(Channel), ESearchCase::IgnoreCase))
+			{
+				FFPSLearningLog::Get().SetBudget(Channel, FCString::Atoi(*Args[1]));
+			}
+		}
+	}));
+
+FFPSLearningLog& FFPSLearningLog::Get()
+{
+	static FFPSLearningLog Instance;
+	return Instance;
+}
+
+FFPSLearningLog::FFPSLearningLog()
+{
+	Entries.SetNum(Capacity);
+	for (int32 Index = 0; Index < Capacity; Index++)
+	{
+		Entries[Index].Sequence.store(Index, std::memory_order_relaxed);
+	}
+
+	// Make sure buffered messages survive a crash
+	FCoreDelegates::OnHandleSystemError.AddRaw(this, &FFPSLearningLog::FlushOnCrash);
+	FCoreDelegates::OnShutdownAfterError.AddRaw(this, &FFPSLearningLog::FlushOnCrash);
+}
+
+bool FFPSLearningLog::ConsumeBudget(EFPSLearningLogChannel Channel)
+{
+	FBudget& Budget = Budgets[(int32)Channel];
+
+	const int64 Second = (int64)FPlatformTime::Seconds();
+	int64 WindowSecond = Budget.WindowSecond.load(std::memory_order_relaxed);
+	if (Second != WindowSecond && Budget.WindowSecond.compare_exchange_strong(WindowSecond, Second, std::memory_order_relaxed))
+	{
+		Budget.Used.store(0, std::memory_order_relaxed);
+	}
+
+	if (Budget.Used.fetch_add(1, std::memory_order_relaxed) < Budget.MessagesPerSecond.load(std::memory_order_relaxed))
+	{
+		return true;
+	}
+
+	Budget.Dropped.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+void FFPSLearningLog::Push(EFPSLearningLogChannel Channel, ELogVerbosity::Type Verbosity, const TCHAR* Message)
+{
+	// Claim the next slot once the flush has read its previous message, or drop the message if the buffer is full
+	FEntry* Entry = nullptr;
+	uint64 Slot = WriteIndex.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		Entry = &Entries[Slot % Capacity];
+		const int64 Lag = (int64)(Entry->Sequence.load(std::memory_order_acquire) - Slot);
+		if (Lag == 0)
+		{
+			if (WriteIndex.compare_exchange_weak(Slot, Slot + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (Lag < 0)
+		{
+			Entry = nullptr;
+			Overflowed.fetch_add(1, std::memory_order_relaxed);
+			break;
+		}
+		else
+		{
+			Slot = WriteIndex.load(std::memory_order_relaxed);
+		}
+	}
+
+	if (Entry)
+	{
+		Entry->Time = FPlatformTime::Seconds();
+		Entry->Channel = Channel;
+		Entry->Verbosity = Verbosity;
+		FCString::Strncpy(Entry->Message, Message, MaxMessageLength);
+
+		// Publishes the message to the flush
+		Entry->Sequence.store(Slot + 1, std::memory_order_release);
+	}
+
+	// Problems shouldn't wait for a flush
+	if (Verbosity <= ELogVerbosity::Warning && GLog)
+	{
+		GLog->Serialize(Message, Verbosity, LogFPSLearning.GetCategoryName());
+	}
+}
+
+void FFPSLearningLog::Flush()
+{
+	FScopeLock Lock(&FlushCriticalSection);
+	FlushLocked();
+}
+
+void FFPSLearningLog::FlushOnCrash()
+{
+	// Waiting could deadlock if the crashing thread is the one flushing
+	if (FlushCriticalSection.TryLock())
+	{
+		FlushLocked();
+		FlushCriticalSection.Unlock();
+	}
+}
+
+void FFPSLearningLog::FlushLocked()
+{
+	if (!GLog)
+	{
+		return;
+	}
+
+	// In order, up to the first slot whose writer hasn't published yet. It is picked up by the next flush
+	for (;; ReadIndex++)
+	{
+		FEntry& Entry = Entries[ReadIndex % Capacity];
+		if (Entry.Sequence.load(std::memory_order_acquire) != ReadIndex + 1)
+		{
+			break;
+		}
+
+		// Warnings and errors were already forwarded when pushed
+		if (Entry.Verbosity > ELogVerbosity::Warning)
+		{
+			GLog->Serialize(*FString::Printf(TEXT("[%.3f][%s] %s"), Entry.Time, GetChannelName(Entry.Channel), Entry.Message),
+				Entry.Verbosity, LogFPSLearning.GetCategoryName());
+		}
+
+		// Hands the slot back to writers, one lap later
+		Entry.Sequence.store(ReadIndex + Capacity, std::memory_order_release);
+	}
+
+	const int32 OverflowedNum = Overflowed.exchange(0, std::memory_order_relaxed);
+	if (OverflowedNum > 0)
+	{
+		GLog->Serialize(*FString::Printf(TEXT("[FPSLearningLog] %d messages dropped while the buffer was full"), OverflowedNum),
+			ELogVerbosity::Log, LogFPSLearning.GetCategoryName());
+	}
+
+	for (int32 ChannelIdx = 0; ChannelIdx < (int32)EFPSLearningLogChannel::Num; ChannelIdx++)
+	{
+		const int32 Dropped = Budgets[ChannelIdx].Dropped.exchange(0, std::memory_order_relaxed);
+		if (Dropped > 0)
+		{
+			GLog->Serialize(*FString::Printf(TEXT("[FPSLearningLog] %d %s messages dropped by rate budget"),
+				Dropped, GetChannelName((EFPSLearningLogChannel)ChannelIdx)), ELogVerbosity::Log, LogFPSLearning.GetCategoryName());
+		}
+	}
+
+	GLog->Flush();
+}
+
+void FFPSLearningLog::SetBudget(EFPSLearningLogChannel Channel, int32 MessagesPerSecond)
+{
+	Budgets[(int32)Channel].MessagesPerSecond.store(FMath::Max(MessagesPerSecond, 0), std::memory_order_relaxed);
+}
+
+const TCHAR* FFPSLearningLog::GetChannelName(EFPSLearningLogChannel Channel)
+{
+	switch (Channel)
+	{
+	case EFPSLearningLogChannel::Manager:		return TEXT("Manager");
+	case EFPSLearningLogChannel::Observation:	return TEXT("Observation");
+	case EFPSLearningLogChannel::Action:		return TEXT("Action");
+	case EFPSLearningLogChannel::Reward:		return TEXT("Reward");
+	case EFPSLearningLogChannel::Completion:	return TEXT("Completion");
+	case EFPSLearningLogChannel::Reset:			return TEXT("Reset");
+	default:									return TEXT("Unknown");
+	}
+}
@@ -0,0 +1,99 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+FPSGAME_API DECLARE_LOG_CATEGORY_EXTERN(LogFPSLearning, Log, All);
+
+/** Sources of learning log messages, each with its own rate budget */
+enum class EFPSLearningLogChannel : uint8
+{
+	Manager,
+	Observation,
+	Action,
+	Reward,
+	Completion,
+	Reset,
+	Num
+};
+
+/**
+ * In-memory log for the learning hot paths.
+ * Messages go into a fixed-size lock-free ring buffer and only reach the output log when flushed
+ * (on demand, from FPS.Learning.FlushLog, when a manager ends play, or on crash). Warnings and errors are
+ * also forwarded immediately. Each channel has a messages-per-second budget; excess messages are counted
+ * and dropped before they are formatted. Messages pushed while the buffer is full are counted and dropped too.
+ */
+class FPSGAME_API FFPSLearningLog
+{
+public:
+	static FFPSLearningLog& Get();
+
+	/** Returns true if the channel still has budget in the current one-second window */
+	bool ConsumeBudget(EFPSLearningLogChannel Channel);
+
+	void Push(EFPSLearningLogChannel Channel, ELogVerbosity::Type Verbosity, const TCHAR* Message);
+
+	/** Writes everything buffered since the last flush to the output log */
+	void Flush();
+
+	/** Flush for the crash delegates, skipped if the crash happened while a flush held the lock */
+	void FlushOnCrash();
+
+	void SetBudget(EFPSLearningLogChannel Channel, int32 MessagesPerSecond);
+
+	static const TCHAR* GetChannelName(EFPSLearningLogChannel Channel);
+
+private:
+	FFPSLearningLog();
+
+	static constexpr int32 Capacity = 2048;
+	static constexpr int32 MaxMessageLength = 256;
+
+	struct FEntry
+	{
+		// Equal to the write index the slot is free for, and that index + 1 once its message is published
+		std::atomic<uint64> Sequence{ 0 };
+		double Time = 0.0;
+		EFPSLearningLogChannel Channel = EFPSLearningLogChannel::Manager;
+		ELogVerbosity::Type Verbosity = ELogVerbosity::Log;
+		TCHAR Message[MaxMessageLength];
+	};
+
+	struct FBudget
+	{
+		std::atomic<int64> WindowSecond{ 0 };
+		std::atomic<int32> Used{ 0 };
+		std::atomic<int32> Dropped{ 0 };
+		std::atomic<int32> MessagesPerSecond{ 60 };
+	};
+
+	void FlushLocked();
+
+	TArray<FEntry> Entries;
+	std::atomic<uint64> WriteIndex{ 0 };
+	std::atomic<int32> Overflowed{ 0 };
+	// Only touched while holding FlushCriticalSection
+	uint64 ReadIndex = 0;
+	FCriticalSection FlushCriticalSection;
+	FBudget Budgets[(int32)EFPSLearningLogChannel::Num];
+};
+
+/**
+ * Logs to the learning ring buffer. Verbosities compiled out for LogFPSLearning generate no code, and the
+ * message is only formatted when the category is active and the channel has budget left.
+ */
+#define FPS_LEARNING_LOG(Channel, Verbosity, Format, ...) \
+	do \
+	{ \
+		if constexpr ((ELogVerbosity::Verbosity & ELogVerbosity::VerbosityMask) <= ELogVerbosity::COMPILED_IN_MINIMUM_VERBOSITY && \
+			(ELogVerbosity::Verbosity & ELogVerbosity::VerbosityMask) <= (int32)FLogCategoryLogFPSLearning::CompileTimeVerbosity) \
+		{ \
+			if (!LogFPSLearning.IsSuppressed(ELogVerbosity::Verbosity) && FFPSLearningLog::Get().ConsumeBudget(EFPSLearningLogChannel::Channel)) \
+			{ \
+				FFPSLearningLog::Get().Push(EFPSLearningLogChannel::Channel, ELogVerbosity::Verbosity, *FString::Printf(Format, ##__VA_ARGS__)); \
+			} \
+		} \
+	} while (0)
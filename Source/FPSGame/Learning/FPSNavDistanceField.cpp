@@ -0,0 +1,262 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSNavDistanceField.h"
+#include "Async/Async.h"
+#include "Engine/World.h"
+
+FFPSNavDistanceField::~FFPSNavDistanceField()
+{
+	// The task only references its own copies, but don't leave it running past the owner
+	if (Pending.IsValid())
+	{
+		Pending.Wait();
+	}
+}
+
+void FFPSNavDistanceField::BuildOccupancy(UWorld* World, const FSettings& InSettings, const AActor* IgnoredActor)
+{
+	Settings = InSettings;
+	Settings.CellSize = FMath::Max(Settings.CellSize, 1.0f);
+
+	Origin = FVector2D(Settings.Center.X - Settings.Extent.X, Settings.Center.Y - Settings.Extent.Y);
+	SizeX = FMath::Max(FMath::CeilToInt(2.0f * Settings.Extent.X / Settings.CellSize), 1);
+	SizeY = FMath::Max(FMath::CeilToInt(2.0f * Settings.Extent.Y / Settings.CellSize), 1);
+
+	TArray<bool> NewBlocked;
+	NewBlocked.Init(false, SizeX * SizeY);
+
+	if (World)
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FPSNavDistanceField), false, IgnoredActor);
+		const FCollisionObjectQueryParams ObjectParams(ECC_WorldStatic);
+		const float HalfCell = 0.5f * Settings.CellSize;
+		const FCollisionShape Probe = FCollisionShape::MakeBox(FVector(HalfCell + Settings.ProbeRadius, HalfCell + Settings.ProbeRadius, 0.5f * Settings.ProbeHeight));
+
+		for (int32 Y = 0; Y < SizeY; Y++)
+		{
+			for (int32 X = 0; X < SizeX; X++)
+			{
+				const FVector CellCenter(
+					Origin.X + (X + 0.5f) * Settings.CellSize,
+					Origin.Y + (Y + 0.5f) * Settings.CellSize,
+					Settings.Center.Z + Settings.ProbeHeight);
+
+				NewBlocked[Y * SizeX + X] = World->OverlapAnyTestByObjectType(CellCenter, FQuat::Identity, ObjectParams, Probe, QueryParams);
+			}
+		}
+	}
+
+	Blocked = MakeShared<TArray<bool>, ESPMode::ThreadSafe>(MoveTemp(NewBlocked));
+	Distances.Reset();
+	bRequestLaunched = false;
+}
+
+void FFPSNavDistanceField::RequestUpdate(const FVector& TargetLocation, float RecomputeDistance)
+{
+	if (bHasRequest && FVector::DistSquared2D(TargetLocation, RequestedTarget) <= FMath::Square(RecomputeDistance))
+	{
+		return;
+	}
+
+	RequestedTarget = TargetLocation;
+	bHasRequest = true;
+	bRequestLaunched = false;
+}
+
+void FFPSNavDistanceField::Tick()
+{
+	if (Pending.IsValid() && Pending.IsReady())
+	{
+		Distances = MakeShared<TArray<float>, ESPMode::ThreadSafe>(Pending.Consume());
+		DistancesTarget = PendingTarget;
+		Pending = TFuture<TArray<float>>();
+	}
+
+	// Only one computation in flight; a target that moved again waits for the next tick
+	if (bHasRequest && !bRequestLaunched && !Pending.IsValid() && HasOccupancy())
+	{
+		Launch();
+	}
+}
+
+void FFPSNavDistanceField::Launch()
+{
+	int32 TargetX, TargetY;
+	if (!GetCell(RequestedTarget, TargetX, TargetY))
+	{
+		// Target outside the arena, nothing sensible to compute
+		bRequestLaunched = true;
+		Distances.Reset();
+		return;
+	}
+
+	PendingTarget = RequestedTarget;
+	bRequestLaunched = true;
+
+	TSharedPtr<const TArray<bool>, ESPMode::ThreadSafe> BlockedCopy = Blocked;
+	const int32 GridX = SizeX;
+	const int32 GridY = SizeY;
+	const float CellSize = Settings.CellSize;
+
+	Pending = Async(EAsyncExecution::ThreadPool, [BlockedCopy, GridX, GridY, CellSize, TargetX, TargetY]()
+	{
+		return ComputeDistances(GridX, GridY, CellSize, *BlockedCopy, TargetX, TargetY);
+	});
+}
+
+TArray<float> FFPSNavDistanceField::ComputeDistances(int32 SizeX, int32 SizeY, float CellSize, const TArray<bool>& Blocked, int32 TargetX, int32 TargetY)
+{
+	TArray<float> Result;
+	Result.Init(UE_BIG_NUMBER, SizeX * SizeY);
+
+	struct FNode
+	{
+		float Distance;
+		int32 Index;
+	};
+	const auto Closer = [](const FNode& A, const FNode& B) { return A.Distance < B.Distance; };
+
+	TArray<FNode> Open;
+	const int32 TargetIndex = TargetY * SizeX + TargetX;
+	Result[TargetIndex] = 0.0f;
+	Open.HeapPush({ 0.0f, TargetIndex }, Closer);
+
+	// 8-connected, no corner cutting past blocked cells
+	static const int32 OffsetX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static const int32 OffsetY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+	const float DiagonalCost = UE_SQRT_2 * CellSize;
+
+	while (Open.Num() > 0)
+	{
+		FNode Node;
+		Open.HeapPop(Node, Closer, EAllowShrinking::No);
+		if (Node.Distance > Result[Node.Index])
+		{
+			continue;
+		}
+
+		const int32 X = Node.Index % SizeX;
+		const int32 Y = Node.Index / SizeX;
+
+		for (int32 Dir = 0; Dir < 8; Dir++)
+		{
+			const int32 NX = X + OffsetX[Dir];
+			const int32 NY = Y + OffsetY[Dir];
+			if (NX < 0 || NX >= SizeX || NY < 0 || NY >= SizeY)
+			{
+				continue;
+			}
+
+			const int32 NIndex = NY * SizeX + NX;
+			if (Blocked[NIndex])
+			{
+				continue;
+			}
+
+			const bool bDiagonal = Dir >= 4;
+			if (bDiagonal && (Blocked[Y * SizeX + NX] || Blocked[NY * SizeX + X]))
+			{
+				continue;
+			}
+
+			const float NewDistance = Node.Distance + (bDiagonal ? DiagonalCost : CellSize);
+			if (NewDistance < Result[NIndex])
+			{
+				Result[NIndex] = NewDistance;
+				Open.HeapPush({ NewDistance, NIndex }, Closer);
+			}
+		}
+	}
+
+	return Result;
+}
+
+bool FFPSNavDistanceField::Sample(const FVector& Location, const FVector& TargetLocation, float Tolerance, float& OutDistance) const
+{
+	if (!Distances.IsValid() || FVector::DistSquared2D(TargetLocation, DistancesTarget) > FMath::Square(Tolerance))
+	{
+		return false;
+	}
+
+	int32 X, Y;
+	if (!GetCell(Location, X, Y))
+	{
+		return false;
+	}
+
+	const TArray<float>& Field = *Distances;
+
+	// Bilinear between the centres of the surrounding free cells, so the distance changes with every step instead
+	// of only when the agent crosses into another cell
+	const float CellX = (Location.X - Origin.X) / Settings.CellSize - 0.5f;
+	const float CellY = (Location.Y - Origin.Y) / Settings.CellSize - 0.5f;
+	const int32 X0 = FMath::FloorToInt(CellX);
+	const int32 Y0 = FMath::FloorToInt(CellY);
+	const float AlphaX = CellX - X0;
+	const float AlphaY = CellY - Y0;
+
+	float WeightedSum = 0.0f;
+	float WeightSum = 0.0f;
+	for (int32 Corner = 0; Corner < 4; Corner++)
+	{
+		const int32 CX = FMath::Clamp(X0 + (Corner & 1), 0, SizeX - 1);
+		const int32 CY = FMath::Clamp(Y0 + (Corner >> 1), 0, SizeY - 1);
+		const float Value = Field[CY * SizeX + CX];
+		if (Value >= UE_BIG_NUMBER)
+		{
+			continue;
+		}
+
+		const float Weight = ((Corner & 1) ? AlphaX : 1.0f - AlphaX) * ((Corner >> 1) ? AlphaY : 1.0f - AlphaY);
+		WeightedSum += Weight * Value;
+		WeightSum += Weight;
+	}
+
+	if (WeightSum > UE_KINDA_SMALL_NUMBER)
+	{
+		OutDistance = WeightedSum / WeightSum;
+		return true;
+	}
+
+	float Best = Field[Y * SizeX + X];
+
+	// Agents brushing a wall can sit in a blocked cell, so take the best free neighbour
+	if (Best >= UE_BIG_NUMBER)
+	{
+		for (int32 NY = FMath::Max(Y - 1, 0); NY <= FMath::Min(Y + 1, SizeY - 1); NY++)
+		{
+			for (int32 NX = FMath::Max(X - 1, 0); NX <= FMath::Min(X + 1, SizeX - 1); NX++)
+			{
+				Best = FMath::Min(Best, Field[NY * SizeX + NX] + Settings.CellSize);
+			}
+		}
+	}
+
+	if (Best >= UE_BIG_NUMBER)
+	{
+		return false;
+	}
+
+	OutDistance = Best;
+	return true;
+}
+
+int32 FFPSNavDistanceField::GetBlockedCellNum() const
+{
+	int32 Count = 0;
+	if (Blocked.IsValid())
+	{
+		for (const bool bBlocked : *Blocked)
+		{
+			Count += bBlocked ? 1 : 0;
+		}
+	}
+	return Count;
+}
+
+bool FFPSNavDistanceField::GetCell(const FVector& Location, int32& OutX, int32& OutY) const
+{
+	OutX = FMath::FloorToInt((Location.X - Origin.X) / Settings.CellSize);
+	OutY = FMath::FloorToInt((Location.Y - Origin.Y) / Settings.CellSize);
+	return OutX >= 0 && OutX < SizeX && OutY >= 0 && OutY < SizeY;
+}
@@ -0,0 +1,73 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+/**
+ * Shortest walkable distance to the target over a 2D grid covering the arena.
+ * The occupancy grid comes from overlap tests against static world geometry and is built once. The distance
+ * field is recomputed with Dijkstra on a thread pool task whenever the target moves, and swapped in on the game
+ * thread, so sampling stays an O(1) lookup.
+ */
+class FPSGAME_API FFPSNavDistanceField
+{
+public:
+	struct FSettings
+	{
+		FVector Center = FVector::ZeroVector;
+		FVector Extent = FVector(2000.0f, 2000.0f, 500.0f);
+		float CellSize = 100.0f;
+
+		// Obstacles are probed with a box this far above Center.Z, clear of the floor
+		float ProbeHeight = 100.0f;
+		float ProbeRadius = 40.0f;
+	};
+
+	~FFPSNavDistanceField();
+
+	void BuildOccupancy(UWorld* World, const FSettings& InSettings, const AActor* IgnoredActor);
+
+	bool HasOccupancy() const { return Blocked.IsValid(); }
+
+	// Asks for a field around TargetLocation if it moved more than RecomputeDistance since the last request
+	void RequestUpdate(const FVector& TargetLocation, float RecomputeDistance);
+
+	// Picks up a finished computation and starts the next one if the target moved meanwhile. Game thread only
+	void Tick();
+
+	/**
+	 * Path distance from Location to the target, interpolated between cell centres, if the current field was built
+	 * for a target within Tolerance of TargetLocation and Location is reachable. Otherwise returns false and the
+	 * caller should fall back.
+	 */
+	bool Sample(const FVector& Location, const FVector& TargetLocation, float Tolerance, float& OutDistance) const;
+
+	int32 GetBlockedCellNum() const;
+
+private:
+	bool GetCell(const FVector& Location, int32& OutX, int32& OutY) const;
+	void Launch();
+
+	static TArray<float> ComputeDistances(int32 SizeX, int32 SizeY, float CellSize, const TArray<bool>& Blocked, int32 TargetX, int32 TargetY);
+
+	FSettings Settings;
+	FVector2D Origin = FVector2D::ZeroVector;
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+
+	TSharedPtr<const TArray<bool>, ESPMode::ThreadSafe> Blocked;
+
+	// Field in use and the target it was built for
+	TSharedPtr<const TArray<float>, ESPMode::ThreadSafe> Distances;
+	FVector DistancesTarget = FVector::ZeroVector;
+
+	// In-flight computation
+	TFuture<TArray<float>> Pending;
+	FVector PendingTarget = FVector::ZeroVector;
+
+	FVector RequestedTarget = FVector::ZeroVector;
+	bool bHasRequest = false;
+	bool bRequestLaunched = false;
+};
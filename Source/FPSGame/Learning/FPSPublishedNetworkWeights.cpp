@@ -0,0 +1,137 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSPublishedNetworkWeights.h"
+#include "LearningAgentsNeuralNetwork.h"
+#include "LearningNeuralNetwork.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace FPSPublishedNetworkWeights
+{
+	static FString GetManifestPath(const FString& Directory)
+	{
+		return Directory / TEXT("Networks.manifest");
+	}
+
+	static FString GetVersionPath(const FString& Directory, const FString& Name, int32 Version)
+	{
+		return Directory / FString::Printf(TEXT("%s.v%d.bin"), *Name, Version);
+	}
+}
+
+int32 FFPSPublishedNetworkWeights::ReadManifestVersion(const FString& Directory)
+{
+	FString Manifest;
+	if (!FFileHelper::LoadFileToString(Manifest, *FPSPublishedNetworkWeights::GetManifestPath(Directory)))
+	{
+		return INDEX_NONE;
+	}
+
+	Manifest.TrimStartAndEndInline();
+	return Manifest.IsNumeric() ? FCString::Atoi(*Manifest) : INDEX_NONE;
+}
+
+bool FFPSPublishedNetworkWeights::Update(TConstArrayView<ULearningAgentsNeuralNetwork*> Networks, TConstArrayView<const TCHAR*> Names, const FString& Directory)
+{
+	check(Networks.Num() == Names.Num());
+
+	const int32 NewVersion = ReadManifestVersion(Directory);
+	if (NewVersion == INDEX_NONE || NewVersion == Version)
+	{
+		return false;
+	}
+
+	// Check the whole set is there before touching any network, so a partly deleted version isn't mixed in
+	for (int32 NetworkIdx = 0; NetworkIdx < Networks.Num(); NetworkIdx++)
+	{
+		const FString FilePath = FPSPublishedNetworkWeights::GetVersionPath(Directory, Names[NetworkIdx], NewVersion);
+		if (Networks[NetworkIdx] == nullptr || Networks[NetworkIdx]->NeuralNetworkData == nullptr || !IFileManager::Get().FileExists(*FilePath))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FPSPublishedNetworkWeights: Missing %s, keeping version %d"), *FilePath, Version);
+			return false;
+		}
+	}
+
+	for (int32 NetworkIdx = 0; NetworkIdx < Networks.Num(); NetworkIdx++)
+	{
+		if (!LoadVersion(Networks[NetworkIdx], FPSPublishedNetworkWeights::GetVersionPath(Directory, Names[NetworkIdx], NewVersion)))
+		{
+			// Version stays as it was, so the next poll loads the whole set again
+			return false;
+		}
+	}
+
+	Version = NewVersion;
+	UE_LOG(LogTemp, Log, TEXT("FPSPublishedNetworkWeights: Loaded version %d"), Version);
+	return true;
+}
+
+bool FFPSPublishedNetworkWeights::LoadVersion(ULearningAgentsNeuralNetwork* Network, const FString& FilePath)
+{
+	TArray<uint8> Snapshot;
+	if (!FFileHelper::LoadFileToArray(Snapshot, *FilePath) || !Network->NeuralNetworkData->LoadFromSnapshot(Snapshot))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPSPublishedNetworkWeights: Failed to load %s"), *FilePath);
+		return false;
+	}
+	return true;
+}
+
+int32 FFPSPublishedNetworkWeights::Publish(TConstArrayView<ULearningAgentsNeuralNetwork*> Networks, TConstArrayView<const TCHAR*> Names, const FString& Directory,
+	int32 KeepVersions)
+{
+	using namespace FPSPublishedNetworkWeights;
+
+	check(Networks.Num() == Names.Num());
+
+	IFileManager& FileManager = IFileManager::Get();
+	FileManager.MakeDirectory(*Directory, true);
+
+	const int32 NewVersion = FMath::Max(ReadManifestVersion(Directory), 0) + 1;
+
+	// Write under temporary names so readers never see a partial version file
+	for (int32 NetworkIdx = 0; NetworkIdx < Networks.Num(); NetworkIdx++)
+	{
+		if (Networks[NetworkIdx] == nullptr)
+		{
+			return INDEX_NONE;
+		}
+
+		const FString VersionPath = GetVersionPath(Directory, Names[NetworkIdx], NewVersion);
+		FFilePath TempFile;
+		TempFile.FilePath = VersionPath + TEXT(".tmp");
+		Networks[NetworkIdx]->SaveNetworkToSnapshot(TempFile);
+		if (!FileManager.Move(*VersionPath, *TempFile.FilePath, true))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FPSPublishedNetworkWeights: Failed to write %s"), *VersionPath);
+			return INDEX_NONE;
+		}
+	}
+
+	// Only now does the new set become visible, all at once
+	const FString ManifestPath = GetManifestPath(Directory);
+	const FString TempManifestPath = ManifestPath + TEXT(".tmp");
+	if (!FFileHelper::SaveStringToFile(FString::FromInt(NewVersion), *TempManifestPath) ||
+		!FileManager.Move(*ManifestPath, *TempManifestPath, true))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FPSPublishedNetworkWeights: Failed to update %s"), *ManifestPath);
+		return INDEX_NONE;
+	}
+
+	// A reader may still be loading an older version, where deleting fails until it is done. That is fine
+	for (const TCHAR* Name : Names)
+	{
+		for (int32 OldVersion = NewVersion - FMath::Max(KeepVersions, 1); OldVersion > 0; OldVersion--)
+		{
+			const FString OldPath = GetVersionPath(Directory, Name, OldVersion);
+			if (!FileManager.FileExists(*OldPath))
+			{
+				break;
+			}
+			FileManager.Delete(*OldPath, false, false, true);
+		}
+	}
+
+	return NewVersion;
+}
@@ -0,0 +1,35 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ULearningAgentsNeuralNetwork;
+
+/**
+ * A set of network weights published to a directory as versioned snapshot files and swapped in atomically.
+ * A writer publishes each update of the set as <Directory>/<Name>.v<N>.bin for every network and then atomically
+ * replaces <Directory>/Networks.manifest, which holds N. Readers load every network at the manifest's version, so
+ * they never mix networks from different updates. Version files are never modified after they are written. Each
+ * reader still deserializes its own copy of the weights.
+ */
+class FPSGAME_API FFPSPublishedNetworkWeights
+{
+public:
+	// Loads the manifest's version of every network if it differs from the loaded one. Returns true if it loaded
+	bool Update(TConstArrayView<ULearningAgentsNeuralNetwork*> Networks, TConstArrayView<const TCHAR*> Names, const FString& Directory);
+
+	// Writes every network as the next version and swaps the manifest. Only the newest KeepVersions files are kept
+	static int32 Publish(TConstArrayView<ULearningAgentsNeuralNetwork*> Networks, TConstArrayView<const TCHAR*> Names, const FString& Directory,
+		int32 KeepVersions = 3);
+
+	// INDEX_NONE when nothing has been published
+	static int32 ReadManifestVersion(const FString& Directory);
+
+	int32 GetVersion() const { return Version; }
+
+private:
+	static bool LoadVersion(ULearningAgentsNeuralNetwork* Network, const FString& FilePath);
+
+	int32 Version = INDEX_NONE;
+};
@@ -0,0 +1,129 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSRayFanSensor.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+void FFPSRayFanSensor::Initialize(const FFPSRayFanSettings& InSettings, int32 MaxAgentNum)
+{
+	Settings = InSettings;
+	AgentNum = MaxAgentNum;
+	RayNum = Settings.GetRayNum();
+
+	LocalDirections.Reset(RayNum);
+	for (int32 PitchIdx = 0; PitchIdx < Settings.PitchRayNum; PitchIdx++)
+	{
+		const float Pitch = Settings.PitchRayNum > 1
+			? -0.5f * Settings.PitchArc + Settings.PitchArc * PitchIdx / (Settings.PitchRayNum - 1)
+			: 0.0f;
+
+		for (int32 YawIdx = 0; YawIdx < Settings.YawRayNum; YawIdx++)
+		{
+			// A full ring would otherwise put the first and last ray on top of each other
+			const int32 YawSteps = Settings.YawArc >= 360.0f ? Settings.YawRayNum : Settings.YawRayNum - 1;
+			const float Yaw = YawSteps > 0
+				? -0.5f * Settings.YawArc + Settings.YawArc * YawIdx / YawSteps
+				: 0.0f;
+
+			LocalDirections.Add(FRotator(Pitch, Yaw, 0.0f).Vector());
+		}
+	}
+
+	AgentStates.Init(FAgentState(), AgentNum);
+	TraceHandles.Init(FTraceHandle(), AgentNum * RayNum);
+	Distances.Init(1.0f, AgentNum * RayNum);
+}
+
+void FFPSRayFanSensor::Update(UWorld* World, TConstArrayView<int32> AgentIds, TFunctionRef<const AActor*(int32)> GetAgentActor)
+{
+	IssuedAgentNum = 0;
+	ReusedAgentNum = 0;
+
+	if (!World || !IsInitialized())
+	{
+		return;
+	}
+
+	const float ReuseDistanceSquared = FMath::Square(Settings.ReuseDistance);
+
+	for (const int32 AgentId : AgentIds)
+	{
+		if (!AgentStates.IsValidIndex(AgentId))
+		{
+			continue;
+		}
+
+		ConsumeResults(World, AgentId);
+
+		const AActor* Agent = GetAgentActor(AgentId);
+		if (!Agent)
+		{
+			continue;
+		}
+
+		FAgentState& State = AgentStates[AgentId];
+		const FVector Location = Agent->GetActorLocation() + FVector(0.0f, 0.0f, Settings.HeightOffset);
+		const FRotator Rotation = Agent->GetActorRotation();
+
+		if (State.bTraced &&
+			FVector::DistSquared(Location, State.Location) <= ReuseDistanceSquared &&
+			FMath::Abs(FRotator::NormalizeAxis(Rotation.Yaw - State.Rotation.Yaw)) <= Settings.ReuseAngle &&
+			FMath::Abs(FRotator::NormalizeAxis(Rotation.Pitch - State.Rotation.Pitch)) <= Settings.ReuseAngle)
+		{
+			ReusedAgentNum++;
+			continue;
+		}
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FPSRayFan), false, Agent);
+		const FQuat AgentQuat = FRotator(0.0f, Rotation.Yaw, 0.0f).Quaternion();
+
+		for (int32 RayIdx = 0; RayIdx < RayNum; RayIdx++)
+		{
+			const FVector End = Location + AgentQuat.RotateVector(LocalDirections[RayIdx]) * Settings.MaxDistance;
+			TraceHandles[AgentId * RayNum + RayIdx] = World->AsyncLineTraceByChannel(
+				EAsyncTraceType::Single, Location, End, Settings.TraceChannel, QueryParams);
+		}
+
+		State.Location = Location;
+		State.Rotation = Rotation;
+		State.bTraced = true;
+		IssuedAgentNum++;
+	}
+}
+
+void FFPSRayFanSensor::ConsumeResults(UWorld* World, int32 AgentId)
+{
+	FTraceDatum Datum;
+	for (int32 RayIdx = 0; RayIdx < RayNum; RayIdx++)
+	{
+		const int32 Index = AgentId * RayNum + RayIdx;
+		FTraceHandle& Handle = TraceHandles[Index];
+		if (!Handle.IsValid())
+		{
+			continue;
+		}
+
+		// Results from a trace that expired before we got to them are dropped and the old distance stays for this
+		// step. The agent is traced again on the next one, even if it hasn't moved past the reuse limits
+		if (World->QueryTraceData(Handle, Datum))
+		{
+			Distances[Index] = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit
+				? FMath::Clamp(Datum.OutHits[0].Distance / Settings.MaxDistance, 0.0f, 1.0f)
+				: 1.0f;
+		}
+		else
+		{
+			AgentStates[AgentId].bTraced = false;
+		}
+		Handle = FTraceHandle();
+	}
+}
+
+TConstArrayView<float> FFPSRayFanSensor::GetDistances(int32 AgentId) const
+{
+	if (!AgentStates.IsValidIndex(AgentId))
+	{
+		return TConstArrayView<float>();
+	}
+	return TConstArrayView<float>(Distances.GetData() + AgentId * RayNum, RayNum);
+}
@@ -0,0 +1,100 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "FPSRayFanSensor.generated.h"
+
+// Layout of the ray fan. Rays are spread over the arcs relative to the agent's facing
+USTRUCT(BlueprintType)
+struct FPSGAME_API FFPSRayFanSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ray Fan")
+	bool bEnabled = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ray Fan", meta = (ClampMin = "1"))
+	int32 YawRayNum = 16;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ray Fan", meta = (ClampMin = "1"))
+	int32 PitchRayNum = 1;
+
+	// Degrees. 360 gives a full ring
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ray Fan", meta = (ClampMin = "0", ClampMax = "360"))
+	float YawArc = 180.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ray Fan", meta = (ClampMin = "0", ClampMax = "180"))
+	float PitchArc = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ray Fan", meta = (ClampMin = "1"))
+	float MaxDistance = 2000.0f;
+
+	// Ray origin above the actor location
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ray Fan")
+	float HeightOffset = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ray Fan")
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_Visibility;
+
+	// Previous results are kept for agents that moved and turned less than this since their last trace
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ray Fan", meta = (ClampMin = "0"))
+	float ReuseDistance = 10.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ray Fan", meta = (ClampMin = "0"))
+	float ReuseAngle = 2.0f;
+
+	int32 GetRayNum() const { return YawRayNum * PitchRayNum; }
+};
+
+/**
+ * Batched lidar-style sensor. Update() collects last step's async trace results and issues new async traces
+ * for every agent that moved, so the physics queries run alongside the rest of the frame and the observation
+ * lags by one decision step.
+ */
+class FPSGAME_API FFPSRayFanSensor
+{
+public:
+	void Initialize(const FFPSRayFanSettings& InSettings, int32 MaxAgentNum);
+
+	bool IsInitialized() const { return AgentNum > 0; }
+
+	void Update(UWorld* World, TConstArrayView<int32> AgentIds, TFunctionRef<const AActor*(int32)> GetAgentActor);
+
+	// Hit distances divided by MaxDistance, 1 for no hit
+	TConstArrayView<float> GetDistances(int32 AgentId) const;
+
+	const FFPSRayFanSettings& GetSettings() const { return Settings; }
+
+	// Traces issued and skipped by the last Update
+	int32 GetIssuedAgentNum() const { return IssuedAgentNum; }
+	int32 GetReusedAgentNum() const { return ReusedAgentNum; }
+
+private:
+	void ConsumeResults(UWorld* World, int32 AgentId);
+
+	struct FAgentState
+	{
+		FVector Location = FVector::ZeroVector;
+		FRotator Rotation = FRotator::ZeroRotator;
+		bool bTraced = false;
+	};
+
+	FFPSRayFanSettings Settings;
+	int32 AgentNum = 0;
+	int32 RayNum = 0;
+
+	// Ray directions in agent space
+	TArray<FVector> LocalDirections;
+
+	TArray<FAgentState> AgentStates;
+
+	// AgentNum * RayNum, indexed by AgentId * RayNum + Ray
+	TArray<FTraceHandle> TraceHandles;
+	TArray<float> Distances;
+
+	int32 IssuedAgentNum = 0;
+	int32 ReusedAgentNum = 0;
+};
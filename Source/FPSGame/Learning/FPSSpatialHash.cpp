@@ -0,0 +1,120 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSSpatialHash.h"
+
+void FFPSSpatialHash::Build(TConstArrayView<FVector> InPositions, float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.0f);
+	InvCellSize = 1.0f / CellSize;
+	Positions.Reset();
+	Positions.Append(InPositions.GetData(), InPositions.Num());
+
+	// Twice as many buckets as points keeps collisions rare
+	const uint32 BucketNum = FMath::RoundUpToPowerOfTwo(FMath::Max(2 * Positions.Num(), 16));
+	BucketMask = BucketNum - 1;
+
+	BucketStart.Reset();
+	BucketStart.SetNumZeroed(BucketNum + 1);
+
+	TArray<uint32, TInlineAllocator<256>> PointBuckets;
+	PointBuckets.SetNumUninitialized(Positions.Num());
+	for (int32 PointIdx = 0; PointIdx < Positions.Num(); PointIdx++)
+	{
+		PointBuckets[PointIdx] = GetBucket(GetCell(Positions[PointIdx]));
+		BucketStart[PointBuckets[PointIdx] + 1]++;
+	}
+
+	for (uint32 BucketIdx = 0; BucketIdx < BucketNum; BucketIdx++)
+	{
+		BucketStart[BucketIdx + 1] += BucketStart[BucketIdx];
+	}
+
+	Entries.SetNumUninitialized(Positions.Num(), EAllowShrinking::No);
+	TArray<int32, TInlineAllocator<256>> Fill;
+	Fill.Append(BucketStart.GetData(), BucketNum);
+	for (int32 PointIdx = 0; PointIdx < Positions.Num(); PointIdx++)
+	{
+		Entries[Fill[PointBuckets[PointIdx]]++] = { GetCell(Positions[PointIdx]), PointIdx };
+	}
+}
+
+int32 FFPSSpatialHash::FindNearest(const FVector& Position, int32 SelfIndex, float MaxDistance, TArrayView<int32> OutIndices) const
+{
+	const int32 MaxNum = OutIndices.Num();
+	if (MaxNum == 0 || Positions.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Kept sorted by distance, MaxNum is small so insertion is cheapest
+	TArray<float, TInlineAllocator<16>> FoundDistSquared;
+	int32 FoundNum = 0;
+
+	const float MaxDistSquared = FMath::Square(MaxDistance);
+	const FIntPoint Center = GetCell(Position);
+	const int32 MaxRing = FMath::CeilToInt(MaxDistance * InvCellSize);
+
+	for (int32 Ring = 0; Ring <= MaxRing; Ring++)
+	{
+		for (int32 Y = Center.Y - Ring; Y <= Center.Y + Ring; Y++)
+		{
+			// Only the outline of the ring, inner cells were searched already
+			const bool bEdgeRow = (Y == Center.Y - Ring || Y == Center.Y + Ring);
+			const int32 XStep = bEdgeRow || Ring == 0 ? 1 : 2 * Ring;
+
+			for (int32 X = Center.X - Ring; X <= Center.X + Ring; X += XStep)
+			{
+				const FIntPoint Cell(X, Y);
+				const uint32 Bucket = GetBucket(Cell);
+
+				for (int32 EntryIdx = BucketStart[Bucket]; EntryIdx < BucketStart[Bucket + 1]; EntryIdx++)
+				{
+					const FEntry& Entry = Entries[EntryIdx];
+					if (Entry.Cell != Cell || Entry.Index == SelfIndex)
+					{
+						continue;
+					}
+
+					const float DistSquared = FVector::DistSquared(Position, Positions[Entry.Index]);
+					if (DistSquared > MaxDistSquared || (FoundNum == MaxNum && DistSquared >= FoundDistSquared[FoundNum - 1]))
+					{
+						continue;
+					}
+
+					int32 Insert = FMath::Min(FoundNum, MaxNum - 1);
+					if (FoundNum < MaxNum)
+					{
+						FoundDistSquared.Add(0.0f);
+						FoundNum++;
+					}
+					while (Insert > 0 && FoundDistSquared[Insert - 1] > DistSquared)
+					{
+						FoundDistSquared[Insert] = FoundDistSquared[Insert - 1];
+						OutIndices[Insert] = OutIndices[Insert - 1];
+						Insert--;
+					}
+					FoundDistSquared[Insert] = DistSquared;
+					OutIndices[Insert] = Entry.Index;
+				}
+			}
+		}
+
+		// Anything in a further ring is at least Ring * CellSize away
+		if (FoundNum == MaxNum && FoundDistSquared[FoundNum - 1] <= FMath::Square(Ring * CellSize))
+		{
+			break;
+		}
+	}
+
+	return FoundNum;
+}
+
+FIntPoint FFPSSpatialHash::GetCell(const FVector& Position) const
+{
+	return FIntPoint(FMath::FloorToInt(Position.X * InvCellSize), FMath::FloorToInt(Position.Y * InvCellSize));
+}
+
+uint32 FFPSSpatialHash::GetBucket(const FIntPoint& Cell) const
+{
+	return ((uint32)Cell.X * 73856093u ^ (uint32)Cell.Y * 19349663u) & BucketMask;
+}
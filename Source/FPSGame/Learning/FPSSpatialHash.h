@@ -0,0 +1,64 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FPSSpatialHash.generated.h"
+
+// K-nearest-agent observation layout
+USTRUCT(BlueprintType)
+struct FPSGAME_API FFPSNeighborSettings
+{
+	GENERATED_BODY()
+
+	// Neighbours observed per agent, 0 disables the observation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Neighbors", meta = (ClampMin = "0"))
+	int32 NeighborNum = 0;
+
+	// Agents further away than this are not observed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Neighbors", meta = (ClampMin = "1"))
+	float MaxDistance = 2000.0f;
+
+	// Grid cell size. Around MaxDistance / 4 keeps the searched ring small
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Neighbors", meta = (ClampMin = "1"))
+	float CellSize = 500.0f;
+};
+
+/**
+ * Uniform 2D grid over agent positions, rebuilt every step with a counting sort. Cells are hashed into a bucket
+ * table so the grid is unbounded; entries remember their cell so hash collisions are filtered out in queries.
+ * Queries are read-only and can run in parallel once Build() has returned.
+ */
+class FPSGAME_API FFPSSpatialHash
+{
+public:
+	void Build(TConstArrayView<FVector> InPositions, float InCellSize);
+
+	/**
+	 * Finds up to OutIndices.Num() nearest points within MaxDistance of Position, closest first.
+	 * SelfIndex is excluded. Returns the number found; indices refer to the positions passed to Build.
+	 */
+	int32 FindNearest(const FVector& Position, int32 SelfIndex, float MaxDistance, TArrayView<int32> OutIndices) const;
+
+	int32 Num() const { return Positions.Num(); }
+
+private:
+	FIntPoint GetCell(const FVector& Position) const;
+	uint32 GetBucket(const FIntPoint& Cell) const;
+
+	struct FEntry
+	{
+		FIntPoint Cell;
+		int32 Index;
+	};
+
+	float CellSize = 500.0f;
+	float InvCellSize = 1.0f / 500.0f;
+	uint32 BucketMask = 0;
+
+	TArray<FVector> Positions;
+
+	// Entries sorted by bucket, BucketStart has BucketNum + 1 offsets into it
+	TArray<FEntry> Entries;
+	TArray<int32> BucketStart;
+};
@@ -3,6 +3,7 @@
 #include "FPSTargetActor.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/Engine.h"
+#include "FPSSignificanceSubsystem.h"
 
 AFPSTargetActor::AFPSTargetActor()
 {
@@ -31,6 +32,22 @@ void AFPSTargetActor::BeginPlay()
 	Super::BeginPlay();
 	
 	UE_LOG(LogTemp, Log, TEXT("FPSTargetActor spawned at location: %s"), *GetActorLocation().ToString());
+
+	// The spin is cosmetic, so it can slow down when nobody is near
+	if (UFPSSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSSignificanceSubsystem>())
+	{
+		Significance->RegisterActor(this);
+	}
+}
+
+void AFPSTargetActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFPSSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSSignificanceSubsystem>())
+	{
+		Significance->UnregisterActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AFPSTargetActor::Tick(float DeltaTime)
@@ -0,0 +1,207 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSTensorboardWriter.h"
+#include "FPSEpisodeStatistics.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+namespace FPSTensorboard
+{
+	// TFRecord framing uses masked CRC32C (Castagnoli)
+	static uint32 Crc32c(const uint8* Data, int64 Num)
+	{
+		static uint32 Table[256];
+		static bool bTableInitialized = false;
+		if (!bTableInitialized)
+		{
+			for (uint32 Index = 0; Index < 256; Index++)
+			{
+				uint32 Crc = Index;
+				for (int32 Bit = 0; Bit < 8; Bit++)
+				{
+					Crc = (Crc & 1) ? (Crc >> 1) ^ 0x82F63B78u : (Crc >> 1);
+				}
+				Table[Index] = Crc;
+			}
+			bTableInitialized = true;
+		}
+
+		uint32 Crc = 0xFFFFFFFFu;
+		for (int64 Index = 0; Index < Num; Index++)
+		{
+			Crc = Table[(Crc ^ Data[Index]) & 0xFF] ^ (Crc >> 8);
+		}
+		return Crc ^ 0xFFFFFFFFu;
+	}
+
+	static uint32 MaskedCrc(const uint8* Data, int64 Num)
+	{
+		const uint32 Crc = Crc32c(Data, Num);
+		return ((Crc >> 15) | (Crc << 17)) + 0xA282EAD8u;
+	}
+
+	// Protobuf wire format helpers
+	static void WriteVarint(TArray<uint8>& Out, uint64 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add((uint8)(Value | 0x80));
+			Value >>= 7;
+		}
+		Out.Add((uint8)Value);
+	}
+
+	static void WriteTag(TArray<uint8>& Out, uint32 Field, uint32 WireType)
+	{
+		WriteVarint(Out, (Field << 3) | WireType);
+	}
+
+	static void WriteDouble(TArray<uint8>& Out, uint32 Field, double Value)
+	{
+		WriteTag(Out, Field, 1);
+		Out.Append((const uint8*)&Value, sizeof(double));
+	}
+
+	static void WriteFloat(TArray<uint8>& Out, uint32 Field, float Value)
+	{
+		WriteTag(Out, Field, 5);
+		Out.Append((const uint8*)&Value, sizeof(float));
+	}
+
+	static void WriteBytes(TArray<uint8>& Out, uint32 Field, const uint8* Data, int32 Num)
+	{
+		WriteTag(Out, Field, 2);
+		WriteVarint(Out, Num);
+		Out.Append(Data, Num);
+	}
+
+	static void WriteString(TArray<uint8>& Out, uint32 Field, const FString& Value)
+	{
+		const FTCHARToUTF8 Utf8(*Value);
+		WriteBytes(Out, Field, (const uint8*)Utf8.Get(), Utf8.Length());
+	}
+
+	static void WritePackedDoubles(TArray<uint8>& Out, uint32 Field, TConstArrayView<double> Values)
+	{
+		WriteTag(Out, Field, 2);
+		WriteVarint(Out, Values.Num() * sizeof(double));
+		Out.Append((const uint8*)Values.GetData(), Values.Num() * sizeof(double));
+	}
+}
+
+FFPSTensorboardWriter::~FFPSTensorboardWriter()
+{
+	Close();
+}
+
+bool FFPSTensorboardWriter::Open(const FString& RunDirectory)
+{
+	Close();
+
+	IFileManager::Get().MakeDirectory(*RunDirectory, true);
+
+	const FString FileName = FString::Printf(TEXT("events.out.tfevents.%lld.%s"),
+		FDateTime::UtcNow().ToUnixTimestamp(), FPlatformProcess::ComputerName());
+	FileHandle = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*(RunDirectory / FileName), true);
+	if (!FileHandle)
+	{
+		return false;
+	}
+
+	// First record identifies the file version
+	TArray<uint8> Event;
+	FPSTensorboard::WriteDouble(Event, 1, FDateTime::UtcNow().ToUnixTimestamp());
+	FPSTensorboard::WriteString(Event, 3, TEXT("brain.Event:2"));
+	WriteRecord(Event);
+	Flush();
+	return true;
+}
+
+void FFPSTensorboardWriter::Close()
+{
+	if (FileHandle)
+	{
+		FileHandle->Flush();
+		delete FileHandle;
+		FileHandle = nullptr;
+	}
+}
+
+void FFPSTensorboardWriter::AddScalar(const FString& Tag, float Value, int64 Step)
+{
+	TArray<uint8> SummaryValue;
+	FPSTensorboard::WriteString(SummaryValue, 1, Tag);
+	FPSTensorboard::WriteFloat(SummaryValue, 2, Value);
+	WriteEvent(SummaryValue, Step);
+}
+
+void FFPSTensorboardWriter::AddHistogram(const FString& Tag, const FFPSHistogram& Histogram, int64 Step)
+{
+	if (Histogram.Num == 0)
+	{
+		return;
+	}
+
+	TArray<double> Buckets;
+	Buckets.Reserve(Histogram.BucketCounts.Num());
+	for (const int32 Count : Histogram.BucketCounts)
+	{
+		Buckets.Add(Count);
+	}
+
+	TArray<uint8> Histo;
+	FPSTensorboard::WriteDouble(Histo, 1, Histogram.Min);
+	FPSTensorboard::WriteDouble(Histo, 2, Histogram.Max);
+	FPSTensorboard::WriteDouble(Histo, 3, Histogram.Num);
+	FPSTensorboard::WriteDouble(Histo, 4, Histogram.Sum);
+	FPSTensorboard::WriteDouble(Histo, 5, Histogram.SumSquares);
+	FPSTensorboard::WritePackedDoubles(Histo, 6, Histogram.BucketLimits);
+	FPSTensorboard::WritePackedDoubles(Histo, 7, Buckets);
+
+	TArray<uint8> SummaryValue;
+	FPSTensorboard::WriteString(SummaryValue, 1, Tag);
+	FPSTensorboard::WriteBytes(SummaryValue, 5, Histo.GetData(), Histo.Num());
+	WriteEvent(SummaryValue, Step);
+}
+
+void FFPSTensorboardWriter::Flush()
+{
+	if (FileHandle)
+	{
+		FileHandle->Flush();
+	}
+}
+
+void FFPSTensorboardWriter::WriteEvent(const TArray<uint8>& SummaryValue, int64 Step)
+{
+	// Event { wall_time = 1; step = 2; summary = 5 { value = 1 } }
+	TArray<uint8> Summary;
+	FPSTensorboard::WriteBytes(Summary, 1, SummaryValue.GetData(), SummaryValue.Num());
+
+	TArray<uint8> Event;
+	FPSTensorboard::WriteDouble(Event, 1, FDateTime::UtcNow().ToUnixTimestamp());
+	FPSTensorboard::WriteTag(Event, 2, 0);
+	FPSTensorboard::WriteVarint(Event, (uint64)Step);
+	FPSTensorboard::WriteBytes(Event, 5, Summary.GetData(), Summary.Num());
+	WriteRecord(Event);
+}
+
+void FFPSTensorboardWriter::WriteRecord(const TArray<uint8>& Data)
+{
+	if (!FileHandle)
+	{
+		return;
+	}
+
+	const uint64 Length = Data.Num();
+	const uint32 LengthCrc = FPSTensorboard::MaskedCrc((const uint8*)&Length, sizeof(Length));
+	const uint32 DataCrc = FPSTensorboard::MaskedCrc(Data.GetData(), Data.Num());
+
+	FileHandle->Write((const uint8*)&Length, sizeof(Length));
+	FileHandle->Write((const uint8*)&LengthCrc, sizeof(LengthCrc));
+	FileHandle->Write(Data.GetData(), Data.Num());
+	FileHandle->Write((const uint8*)&DataCrc, sizeof(DataCrc));
+}
@@ -0,0 +1,33 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IFileHandle;
+struct FFPSHistogram;
+
+/**
+ * Minimal TensorBoard event file writer (scalars and histograms).
+ * Writes the tfevents record format directly so the game can log its own summaries next to the trainer's runs.
+ */
+class FFPSTensorboardWriter
+{
+public:
+	~FFPSTensorboardWriter();
+
+	/** Creates a new event file inside RunDirectory */
+	bool Open(const FString& RunDirectory);
+	void Close();
+	bool IsOpen() const { return FileHandle != nullptr; }
+
+	void AddScalar(const FString& Tag, float Value, int64 Step);
+	void AddHistogram(const FString& Tag, const FFPSHistogram& Histogram, int64 Step);
+	void Flush();
+
+private:
+	void WriteEvent(const TArray<uint8>& SummaryValue, int64 Step);
+	void WriteRecord(const TArray<uint8>& Data);
+
+	IFileHandle* FileHandle = nullptr;
+};
@@ -0,0 +1,171 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSTrainerProcessSubsystem.h"
+#include "Async/Async.h"
+#include "HAL/PlatformTime.h"
+#include "LearningTrainer.h"
+
+void UFPSTrainerProcessSubsystem::Deinitialize()
+{
+	// Launches still in flight have to finish before their processes can be torn down
+	for (FTrainerEntry& Entry : Trainers)
+	{
+		if (Entry.Launch.IsValid())
+		{
+			Entry.Launch.Wait();
+		}
+	}
+	Trainers.Reset();
+
+	Super::Deinitialize();
+}
+
+int32 UFPSTrainerProcessSubsystem::RequestTrainer(const FLearningAgentsTrainerProcessSettings& TrainerProcessSettings,
+	const FLearningAgentsSharedMemoryCommunicatorSettings& SharedMemorySettings)
+{
+	const uint32 SettingsHash = HashSettings(TrainerProcessSettings, SharedMemorySettings);
+
+	// Settle kept-alive trainers that finished winding down, then drop those that didn't answer or have gone away
+	for (FTrainerEntry& Entry : Trainers)
+	{
+		if (!Entry.bInUse && Entry.Launch.IsValid() && Entry.Launch.IsReady())
+		{
+			Entry.Communicator = Entry.Launch.Consume();
+			Entry.Launch = TFuture<FLearningAgentsCommunicator>();
+			Entry.bReady = Entry.Communicator.Trainer.IsValid();
+		}
+	}
+	Trainers.RemoveAll([](const FTrainerEntry& Entry) { return !Entry.bInUse && !Entry.Launch.IsValid() && (!Entry.bReady || !IsTrainerRunning(Entry)); });
+
+	for (FTrainerEntry& Entry : Trainers)
+	{
+		if (!Entry.bInUse && Entry.SettingsHash == SettingsHash)
+		{
+			Entry.bInUse = true;
+			UE_LOG(LogTemp, Log, TEXT("FPSTrainerProcessSubsystem: Reattaching to kept-alive trainer %d"), Entry.Handle);
+			return Entry.Handle;
+		}
+	}
+
+	FTrainerEntry& Entry = Trainers.AddDefaulted_GetRef();
+	Entry.Handle = NextHandle++;
+	Entry.SettingsHash = SettingsHash;
+	Entry.bInUse = true;
+	Entry.LaunchStartTime = FPlatformTime::Seconds();
+
+	// Process creation, shared memory setup and waiting for the interpreter don't touch UObjects, so they can
+	// overlap level loading instead of blocking the first training step
+	Entry.Launch = Async(EAsyncExecution::Thread, [TrainerProcessSettings, SharedMemorySettings]()
+	{
+		FLearningAgentsCommunicator Communicator = ULearningAgentsCommunicatorLibrary::MakeSharedMemoryTrainingProcess(TrainerProcessSettings, SharedMemorySettings);
+		WaitForTrainer(Communicator);
+		return Communicator;
+	});
+
+	UE_LOG(LogTemp, Log, TEXT("FPSTrainerProcessSubsystem: Launching trainer %d"), Entry.Handle);
+	return Entry.Handle;
+}
+
+bool UFPSTrainerProcessSubsystem::TryGetTrainer(int32 Handle, FLearningAgentsCommunicator& OutCommunicator)
+{
+	FTrainerEntry* Entry = Trainers.FindByPredicate([Handle](const FTrainerEntry& Entry) { return Entry.Handle == Handle; });
+	if (!Entry)
+	{
+		return false;
+	}
+
+	if (!Entry->bReady)
+	{
+		if (!Entry->Launch.IsValid() || !Entry->Launch.IsReady())
+		{
+			return false;
+		}
+
+		Entry->Communicator = Entry->Launch.Consume();
+		Entry->Launch = TFuture<FLearningAgentsCommunicator>();
+		if (!Entry->Communicator.Trainer.IsValid())
+		{
+			UE_LOG(LogTemp, Error, TEXT("FPSTrainerProcessSubsystem: Trainer %d did not answer"), Handle);
+			return false;
+		}
+
+		Entry->bReady = true;
+		UE_LOG(LogTemp, Log, TEXT("FPSTrainerProcessSubsystem: Trainer %d ready in %.2f s"), Handle, FPlatformTime::Seconds() - Entry->LaunchStartTime);
+	}
+
+	OutCommunicator = Entry->Communicator;
+	return true;
+}
+
+void UFPSTrainerProcessSubsystem::ReleaseTrainer(int32 Handle, bool bKeepAlive)
+{
+	const int32 Index = Trainers.IndexOfByPredicate([Handle](const FTrainerEntry& Entry) { return Entry.Handle == Handle; });
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	FTrainerEntry& Entry = Trainers[Index];
+	if (bKeepAlive && (Entry.bReady || Entry.Launch.IsValid()))
+	{
+		// Not ready again until it has wound down the previous session, TryGetTrainer waits for that
+		if (Entry.bReady)
+		{
+			Entry.bReady = false;
+			Entry.LaunchStartTime = FPlatformTime::Seconds();
+			Entry.Launch = Async(EAsyncExecution::Thread, [Communicator = Entry.Communicator]() mutable
+			{
+				WaitForTrainer(Communicator);
+				return Communicator;
+			});
+		}
+
+		Entry.bInUse = false;
+		UE_LOG(LogTemp, Log, TEXT("FPSTrainerProcessSubsystem: Keeping trainer %d alive"), Handle);
+		return;
+	}
+
+	if (Entry.Launch.IsValid())
+	{
+		Entry.Launch.Wait();
+	}
+	Trainers.RemoveAt(Index);
+}
+
+int32 UFPSTrainerProcessSubsystem::GetKeptAliveNum() const
+{
+	int32 Count = 0;
+	for (const FTrainerEntry& Entry : Trainers)
+	{
+		Count += Entry.bInUse ? 0 : 1;
+	}
+	return Count;
+}
+
+uint32 UFPSTrainerProcessSubsystem::HashSettings(const FLearningAgentsTrainerProcessSettings& TrainerProcessSettings,
+	const FLearningAgentsSharedMemoryCommunicatorSettings& SharedMemorySettings)
+{
+	FString Text;
+	FLearningAgentsTrainerProcessSettings::StaticStruct()->ExportText(Text, &TrainerProcessSettings, nullptr, nullptr, PPF_None, nullptr);
+	FLearningAgentsSharedMemoryCommunicatorSettings::StaticStruct()->ExportText(Text, &SharedMemorySettings, nullptr, nullptr, PPF_None, nullptr);
+	return GetTypeHash(Text);
+}
+
+bool UFPSTrainerProcessSubsystem::IsTrainerRunning(const FTrainerEntry& Entry)
+{
+	return Entry.Communicator.TrainerProcess.IsValid() && Entry.Communicator.TrainerProcess->IsRunning();
+}
+
+void UFPSTrainerProcessSubsystem::WaitForTrainer(FLearningAgentsCommunicator& Communicator)
+{
+	if (!Communicator.Trainer.IsValid())
+	{
+		return;
+	}
+
+	const UE::Learning::ETrainerResponse Response = Communicator.Trainer->Wait();
+	if (Response == UE::Learning::ETrainerResponse::Unexpected || Response == UE::Learning::ETrainerResponse::Timeout)
+	{
+		Communicator = FLearningAgentsCommunicator();
+	}
+}
@@ -0,0 +1,60 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Async/Future.h"
+#include "LearningAgentsCommunicator.h"
+#include "FPSTrainerProcessSubsystem.generated.h"
+
+/**
+ * Owns Python trainer processes independently of any world.
+ * Managers request a trainer while their level is still loading; the process is launched and waited on until it
+ * answers on a background thread, and picked up once it is ready. Released trainers can be kept alive and handed to
+ * the next manager asking with the same settings, so PIE sessions and map reloads skip the interpreter and library
+ * startup. A kept-alive trainer is only handed out again once it has confirmed on the same thread that it is idle.
+ */
+UCLASS()
+class FPSGAME_API UFPSTrainerProcessSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Reattaches to an idle kept-alive trainer with matching settings or starts launching a new one. Returns a handle
+	int32 RequestTrainer(const FLearningAgentsTrainerProcessSettings& TrainerProcessSettings,
+		const FLearningAgentsSharedMemoryCommunicatorSettings& SharedMemorySettings);
+
+	// True once the trainer for Handle has been launched and answered, filling OutCommunicator
+	bool TryGetTrainer(int32 Handle, FLearningAgentsCommunicator& OutCommunicator);
+
+	// Lets go of a trainer. Kept-alive trainers stay running for the next request with the same settings
+	void ReleaseTrainer(int32 Handle, bool bKeepAlive);
+
+	int32 GetKeptAliveNum() const;
+
+private:
+	struct FTrainerEntry
+	{
+		int32 Handle = INDEX_NONE;
+		uint32 SettingsHash = 0;
+		// Launch or idle wait in flight. Yields an empty communicator when the trainer didn't answer
+		TFuture<FLearningAgentsCommunicator> Launch;
+		FLearningAgentsCommunicator Communicator;
+		double LaunchStartTime = 0.0;
+		bool bReady = false;
+		bool bInUse = false;
+	};
+
+	static uint32 HashSettings(const FLearningAgentsTrainerProcessSettings& TrainerProcessSettings,
+		const FLearningAgentsSharedMemoryCommunicatorSettings& SharedMemorySettings);
+	static bool IsTrainerRunning(const FTrainerEntry& Entry);
+
+	// Blocks until the trainer answers, resetting Communicator if it doesn't. Only for background threads
+	static void WaitForTrainer(FLearningAgentsCommunicator& Communicator);
+
+	TArray<FTrainerEntry> Trainers;
+	int32 NextHandle = 0;
+};
@@ -0,0 +1,43 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Training environment bookkeeping for one agent's current episode
+struct FFPSAgentEpisodeState
+{
+	int32 EpisodeStep = 0;
+	float PreviousDistance = 0.0f;
+	bool bHasPreviousDistance = false;
+	bool bPreviousDistanceIsNavigation = false;
+	float LastReward = 0.0f;
+};
+
+struct FFPSAgentSnapshot
+{
+	int32 AgentId = INDEX_NONE;
+	FTransform Transform = FTransform::Identity;
+	FVector Velocity = FVector::ZeroVector;
+	FRotator ControlRotation = FRotator::ZeroRotator;
+	FFPSAgentEpisodeState Episode;
+};
+
+/**
+ * Everything needed to put a manager's agents and target back exactly where they were.
+ * Reserve() once; capturing into a reserved snapshot doesn't allocate.
+ */
+struct FFPSWorldSnapshot
+{
+	void Reserve(int32 AgentNum)
+	{
+		Agents.Reserve(AgentNum);
+	}
+
+	bool IsValid() const { return bValid; }
+
+	TArray<FFPSAgentSnapshot> Agents;
+	FTransform TargetTransform = FTransform::Identity;
+	float WorldTime = 0.0f;
+	bool bValid = false;
+};
@@ -5,14 +5,19 @@
 #include "Perception/PawnSensingComponent.h"
 #include "DrawDebugHelpers.h"
 #include "FPSGameMode.h"
+#include "FPSGuardPerceptionSubsystem.h"
+#include "FPSNoiseSubsystem.h"
+#include "FPSSignificanceSubsystem.h"
+#include "FPSPatrolRoute.h"
+#include "AIController.h"
 #include "Blueprint/AIBlueprintHelperLibrary.h"
 #include "Net/UnrealNetwork.h"
 
 // Sets default values
 AFPSAIGuard::AFPSAIGuard()
 {
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Patrol arrival comes from the controller's move completed event and sensing from subsystems, nothing ticks
+	PrimaryActorTick.bCanEverTick = false;
 
 	PawnSensingComp = CreateDefaultSubobject<UPawnSensingComponent>(TEXT("PawnSensingComp"));
 
@@ -29,12 +34,54 @@ void AFPSAIGuard::BeginPlay()
 	Super::BeginPlay();
 	OriginalRotation = GetActorRotation();
 
+	UFPSGuardPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UFPSGuardPerceptionSubsystem>();
+	if (bUseSharedPerception && Perception)
+	{
+		Perception->RegisterGuard(this);
+	}
+
+	UFPSNoiseSubsystem* Noise = GetWorld()->GetSubsystem<UFPSNoiseSubsystem>();
+	if (bUseSharedPerception && Noise)
+	{
+		Noise->RegisterListener(PawnSensingComp);
+	}
+
+	if (UFPSSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSSignificanceSubsystem>())
+	{
+		Significance->RegisterActor(this);
+	}
+
 	if (bPatrol)
 	{
+		if (AAIController* AIController = Cast<AAIController>(GetController()))
+		{
+			AIController->ReceiveMoveCompleted.AddUniqueDynamic(this, &AFPSAIGuard::OnMoveCompleted);
+		}
+
 		MoveToNextPatrolPoint();
 	}
 }
 
+void AFPSAIGuard::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFPSGuardPerceptionSubsystem* Perception = GetWorld()->GetSubsystem<UFPSGuardPerceptionSubsystem>())
+	{
+		Perception->UnregisterGuard(this);
+	}
+
+	if (UFPSNoiseSubsystem* Noise = GetWorld()->GetSubsystem<UFPSNoiseSubsystem>())
+	{
+		Noise->UnregisterListener(PawnSensingComp);
+	}
+
+	if (UFPSSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSSignificanceSubsystem>())
+	{
+		Significance->UnregisterActor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AFPSAIGuard::OnPawnSeen(APawn* SeenPawn)
 {
 	if (SeenPawn == nullptr)
@@ -124,6 +171,18 @@ void AFPSAIGuard::SetGuardState(EAIState NewState)
 
 void AFPSAIGuard::MoveToNextPatrolPoint()
 {
+	AAIController* AIController = Cast<AAIController>(GetController());
+
+	if (PatrolRoute && PatrolRoute->GetWaypointNum() > 0)
+	{
+		PatrolWaypoint = PatrolRoute->GetNextWaypoint(PatrolWaypoint, PatrolDirection, GetActorLocation());
+		if (AIController)
+		{
+			AIController->MoveToLocation(PatrolRoute->GetWaypoint(PatrolWaypoint), PatrolAcceptanceRadius);
+		}
+		return;
+	}
+
 	if (CurrentPatrolPoint == nullptr || CurrentPatrolPoint == SecondPatrolPoint)
 	{
 		CurrentPatrolPoint = FirstPatrolPoint;
@@ -133,24 +192,33 @@ void AFPSAIGuard::MoveToNextPatrolPoint()
 		CurrentPatrolPoint = SecondPatrolPoint;
 	}
 
-	UAIBlueprintHelperLibrary::SimpleMoveToActor(GetController(), CurrentPatrolPoint);
+	if (AIController)
+	{
+		AIController->MoveToActor(CurrentPatrolPoint, PatrolAcceptanceRadius);
+	}
+	else
+	{
+		UAIBlueprintHelperLibrary::SimpleMoveToActor(GetController(), CurrentPatrolPoint);
+	}
 }
 
-// Called every frame
-void AFPSAIGuard::Tick(float DeltaTime)
+void AFPSAIGuard::OnMoveCompleted(FAIRequestID RequestID, EPathFollowingResult::Type Result)
 {
-	Super::Tick(DeltaTime);
+	// Aborted moves are the guard stopping to look at something, ResetOrientation resumes the patrol.
+	// Blocked points are skipped like reached ones
+	if (!bPatrol || GuardState != EAIState::Idle || (Result != EPathFollowingResult::Success && Result != EPathFollowingResult::Blocked))
+	{
+		return;
+	}
 
-	if (CurrentPatrolPoint)
+	// A single waypoint is a post to stand at, not a patrol
+	if (PatrolRoute && PatrolRoute->GetWaypointNum() == 1)
 	{
-		FVector Delta = GetActorLocation() - CurrentPatrolPoint->GetActorLocation();
-		float DistanceToPatrolPoint = Delta.Size();
-		if (DistanceToPatrolPoint < 50)
-		{
-			MoveToNextPatrolPoint();
-		}
+		return;
 	}
 
+	// Next tick, as moves that finish immediately (already at the goal) report completion from inside MoveTo
+	GetWorldTimerManager().SetTimerForNextTick(this, &AFPSAIGuard::MoveToNextPatrolPoint);
 }
 
 void AFPSAIGuard::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
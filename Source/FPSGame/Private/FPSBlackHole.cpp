@@ -4,12 +4,14 @@
 #include "FPSBlackHole.h"
 #include "Components/StaticMeshComponent.h"
 #include "Components/SphereComponent.h"
+#include "FPSProjectile.h"
+#include "FPSProjectilePoolSubsystem.h"
 
 // Sets default values
 AFPSBlackHole::AFPSBlackHole()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+ 	// Gravity is applied by UFPSGravityFieldSubsystem, so the black hole itself doesn't tick
+	PrimaryActorTick.bCanEverTick = false;
 	MeshComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("MeshComp"));
 	MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	RootComponent = MeshComp;
@@ -24,45 +26,69 @@ AFPSBlackHole::AFPSBlackHole()
 	OuterSphereComp->SetSphereRadius(2000);
 	OuterSphereComp->SetupAttachment(MeshComp);
 
+	OuterSphereComp->OnComponentBeginOverlap.AddDynamic(this, &AFPSBlackHole::OnOuterOverlapBegin);
+	OuterSphereComp->OnComponentEndOverlap.AddDynamic(this, &AFPSBlackHole::OnOuterOverlapEnd);
+
 }
 
 void AFPSBlackHole::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
 	if ((OtherActor != nullptr) && (OtherActor != this) && (OtherComp != nullptr))
 	{
+		// Pooled projectiles go back to their pool instead of being destroyed
+		AFPSProjectile* Projectile = Cast<AFPSProjectile>(OtherActor);
+		if (Projectile && !HasAuthority())
+		{
+			// The server removes replicated projectiles
+			return;
+		}
+
+		UFPSProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UFPSProjectilePoolSubsystem>();
+		if (Projectile && Projectile->bPooled && ProjectilePool)
+		{
+			ProjectilePool->Release(Projectile);
+			return;
+		}
+
 		OtherActor->Destroy();
 	}
 
 }
 
+void AFPSBlackHole::OnOuterOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (UFPSGravityFieldSubsystem* GravityField = GetWorld()->GetSubsystem<UFPSGravityFieldSubsystem>())
+	{
+		GravityField->AddMember(GravitySource, OtherComp);
+	}
+}
+
+void AFPSBlackHole::OnOuterOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	if (UFPSGravityFieldSubsystem* GravityField = GetWorld()->GetSubsystem<UFPSGravityFieldSubsystem>())
+	{
+		GravityField->RemoveMember(GravitySource, OtherComp);
+	}
+}
+
 // Called when the game starts or when spawned
 void AFPSBlackHole::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (UFPSGravityFieldSubsystem* GravityField = GetWorld()->GetSubsystem<UFPSGravityFieldSubsystem>())
+	{
+		GravitySource = GravityField->RegisterSource(OuterSphereComp, ForceStrength, Falloff, InnerSphereComp->GetScaledSphereRadius());
+	}
 }
 
-// Called every frame
-void AFPSBlackHole::Tick(float DeltaTime)
+void AFPSBlackHole::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
-
-	TArray<UPrimitiveComponent*> OverlappingComponents;
-	OuterSphereComp->GetOverlappingComponents(OverlappingComponents);
-
-	for (int32 i = 0; i < OverlappingComponents.Num(); i++)
+	if (UFPSGravityFieldSubsystem* GravityField = GetWorld()->GetSubsystem<UFPSGravityFieldSubsystem>())
 	{
-		UPrimitiveComponent* PrimComp = OverlappingComponents[i];
-		if (PrimComp && PrimComp->IsSimulatingPhysics())
-		{
-			// TODO: not sure if it's a good idea to have these consts declared here
-			const float SphereRadius = OuterSphereComp->GetScaledSphereRadius();
-			const float ForceStrength = -2000;
-
-			PrimComp->AddRadialForce(GetActorLocation(), SphereRadius, ForceStrength, ERadialImpulseFalloff::RIF_Constant, true);
-		}
+		GravityField->UnregisterSource(GravitySource);
+		GravitySource = INDEX_NONE;
 	}
 
-
+	Super::EndPlay(EndPlayReason);
 }
-
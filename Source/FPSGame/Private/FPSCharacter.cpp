@@ -2,11 +2,15 @@
 
 #include "FPSCharacter.h"
 #include "FPSProjectile.h"
+#include "FPSProjectilePoolSubsystem.h"
+#include "FPSProjectileSimulationSubsystem.h"
+#include "FPSHitscanSubsystem.h"
 #include "Animation/AnimInstance.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/PawnNoiseEmitterComponent.h"
+#include "GameFramework/GameStateBase.h"
 #include "Net/UnrealNetwork.h"
 
 
@@ -34,6 +38,18 @@ AFPSCharacter::AFPSCharacter()
 }
 
 
+void AFPSCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UFPSProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UFPSProjectilePoolSubsystem>();
+	if (HasAuthority() && ProjectilePool && FireMode == EFPSFireMode::Actor)
+	{
+		ProjectilePool->Prewarm(ProjectileClass, ProjectilePoolSize);
+	}
+}
+
+
 void AFPSCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
 	// set up gameplay key bindings
@@ -65,7 +81,14 @@ void AFPSCharacter::Tick(float DeltaTime)
 
 void AFPSCharacter::Fire()
 {
-	ServerFire();
+	if (FireMode == EFPSFireMode::Predicted)
+	{
+		FirePredicted();
+	}
+	else
+	{
+		ServerFire();
+	}
 
 	// try and play the sound if specified
 	if (FireSound)
@@ -93,6 +116,29 @@ void AFPSCharacter::ServerFire_Implementation()
 		FVector MuzzleLocation = GunMeshComponent->GetSocketLocation("Muzzle");
 		FRotator MuzzleRotation = GunMeshComponent->GetSocketRotation("Muzzle");
 
+		// traced together with every other shot this frame
+		UFPSHitscanSubsystem* Hitscan = GetWorld()->GetSubsystem<UFPSHitscanSubsystem>();
+		if (FireMode == EFPSFireMode::Hitscan && Hitscan)
+		{
+			Hitscan->QueueShot(ProjectileClass, MuzzleLocation, MuzzleRotation.Vector(), HitscanRange, this);
+			return;
+		}
+
+		// no actor at all, the world's projectile simulation tracks it
+		UFPSProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UFPSProjectileSimulationSubsystem>();
+		if (FireMode == EFPSFireMode::Simulated && ProjectileSimulation)
+		{
+			ProjectileSimulation->Fire(ProjectileClass, MuzzleLocation, MuzzleRotation, this);
+			return;
+		}
+
+		// reuse a pooled projectile when the world has a pool
+		if (UFPSProjectilePoolSubsystem* ProjectilePool = GetWorld()->GetSubsystem<UFPSProjectilePoolSubsystem>())
+		{
+			ProjectilePool->Acquire(ProjectileClass, MuzzleLocation, MuzzleRotation, this);
+			return;
+		}
+
 		//Set Spawn Collision Handling Override
 		FActorSpawnParameters ActorSpawnParams;
 		ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
@@ -109,6 +155,87 @@ bool AFPSCharacter::ServerFire_Validate()
 	return true;
 }
 
+void AFPSCharacter::FirePredicted()
+{
+	AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (ProjectileClass == nullptr || GameState == nullptr)
+	{
+		return;
+	}
+
+	FFPSProjectileFireEvent FireEvent;
+	FireEvent.Origin = GunMeshComponent->GetSocketLocation("Muzzle");
+	FireEvent.Direction = GunMeshComponent->GetSocketRotation("Muzzle").Vector();
+	FireEvent.Time = (float)GameState->GetServerWorldTimeSeconds();
+	FireEvent.Seed = (uint16)FMath::Rand();
+	FireEvent.Quantize();
+
+	// the shooter sees the shot leave the muzzle now, without waiting for the server
+	UFPSProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UFPSProjectileSimulationSubsystem>();
+	if (!HasAuthority() && ProjectileSimulation)
+	{
+		ProjectileSimulation->FirePredicted(ProjectileClass, FireEvent, this, FireSpreadDegrees, 0.0f, true);
+	}
+
+	ServerFirePredicted(FireEvent);
+}
+
+void AFPSCharacter::ServerFirePredicted_Implementation(const FFPSProjectileFireEvent& FireEvent)
+{
+	UFPSProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UFPSProjectileSimulationSubsystem>();
+	if (ProjectileClass == nullptr || ProjectileSimulation == nullptr)
+	{
+		return;
+	}
+
+	// the muzzle is never far from the pawn, drop shots claiming otherwise
+	if (FVector::DistSquared(FireEvent.Origin, GetActorLocation()) > FMath::Square(500.0f))
+	{
+		return;
+	}
+
+	// catch up with where the shooter already sees the projectile, up to a limit so lag can't buy range
+	const float Advance = FMath::Clamp((float)GetWorld()->GetTimeSeconds() - FireEvent.Time, 0.0f, MaxPredictionAge);
+	ProjectileSimulation->FirePredicted(ProjectileClass, FireEvent, this, FireSpreadDegrees, Advance, false);
+
+	MulticastFirePredicted(FireEvent);
+}
+
+bool AFPSCharacter::ServerFirePredicted_Validate(const FFPSProjectileFireEvent& FireEvent)
+{
+	return true;
+}
+
+void AFPSCharacter::MulticastFirePredicted_Implementation(const FFPSProjectileFireEvent& FireEvent)
+{
+	// the server has the real copy and the shooter predicted its own
+	if (HasAuthority() || IsLocallyControlled())
+	{
+		return;
+	}
+
+	UFPSProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UFPSProjectileSimulationSubsystem>();
+	AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (ProjectileClass && ProjectileSimulation && GameState)
+	{
+		const float Advance = FMath::Clamp((float)GameState->GetServerWorldTimeSeconds() - FireEvent.Time, 0.0f, MaxPredictionAge);
+		ProjectileSimulation->FirePredicted(ProjectileClass, FireEvent, this, FireSpreadDegrees, Advance, true);
+	}
+}
+
+void AFPSCharacter::MulticastPredictedImpact_Implementation(uint16 Seed)
+{
+	if (HasAuthority())
+	{
+		return;
+	}
+
+	if (UFPSProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UFPSProjectileSimulationSubsystem>())
+	{
+		ProjectileSimulation->CorrectPredicted(this, Seed);
+	}
+}
+
 
 void AFPSCharacter::MoveForward(float Value)
 {
@@ -132,8 +259,7 @@ void AFPSCharacter::MoveRight(float Value)
 void AFPSCharacter::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(AFPSCharacter, bIsCarryingObjective);
 
-	//Optimization:
-	//DOREPLIFETIME(AFPSCharacter, bIsCarryingObjective, COND_OwnerOnly);
+	// Only the carrier's own client needs it, the server decides extraction
+	DOREPLIFETIME_CONDITION(AFPSCharacter, bIsCarryingObjective, COND_OwnerOnly);
 }
\ No newline at end of file
@@ -11,8 +11,8 @@
 // Sets default values
 AFPSExtractionZone::AFPSExtractionZone()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Nothing to do per frame
+	PrimaryActorTick.bCanEverTick = false;
 
 	OverlapComp = CreateDefaultSubobject<UBoxComponent>(TEXT("OverlapComp"));
 	OverlapComp->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
@@ -28,6 +28,9 @@ AFPSExtractionZone::AFPSExtractionZone()
 	DecalComp = CreateDefaultSubobject<UDecalComponent>(TEXT("DecalComp"));
 	DecalComp->DecalSize = FVector(200.0f, 200.0f, 200.0f);
 	DecalComp->SetupAttachment(RootComponent);
+
+	// Never changes after load, so it stays dormant if a Blueprint turns on replication
+	NetDormancy = DORM_Initial;
 }
 
 void AFPSExtractionZone::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -51,8 +54,9 @@ void AFPSExtractionZone::OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AAc
 			}
 
 		}
-		else
+		else if (MyPawn->IsLocallyControlled())
 		{
+			// Other players' carrying state isn't replicated, so only the local player is told
 			UGameplayStatics::PlaySound2D(this, ObjectiveMissingSound);
 		}
 	}
@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSGravityFieldSubsystem.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+
+bool UFPSGravityFieldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFPSGravityFieldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSGravityFieldSubsystem, STATGROUP_Tickables);
+}
+
+int32 UFPSGravityFieldSubsystem::RegisterSource(USphereComponent* Field, float Strength, EFPSGravityFalloff Falloff, float CoreRadius)
+{
+	if (Field == nullptr)
+	{
+		return INDEX_NONE;
+	}
+
+	FGravitySource Source;
+	Source.Field = Field;
+	Source.Strength = Strength;
+	Source.Falloff = Falloff;
+	Source.CoreRadius = CoreRadius;
+	const int32 SourceIndex = Sources.Add(Source);
+
+	// Level-placed sources don't get begin overlap events for what is already inside them
+	TArray<UPrimitiveComponent*> OverlappingComponents;
+	Field->GetOverlappingComponents(OverlappingComponents);
+	for (UPrimitiveComponent* Component : OverlappingComponents)
+	{
+		AddMember(SourceIndex, Component);
+	}
+
+	return SourceIndex;
+}
+
+void UFPSGravityFieldSubsystem::UnregisterSource(int32 Source)
+{
+	if (!Sources.IsValidIndex(Source))
+	{
+		return;
+	}
+
+	for (int32 BodyIndex = Bodies.Num() - 1; BodyIndex >= 0; BodyIndex--)
+	{
+		Bodies[BodyIndex].Sources.RemoveSingleSwap(Source);
+		if (Bodies[BodyIndex].Sources.Num() == 0)
+		{
+			RemoveBody(BodyIndex);
+		}
+	}
+	Sources.RemoveAt(Source);
+}
+
+void UFPSGravityFieldSubsystem::AddMember(int32 Source, UPrimitiveComponent* Component)
+{
+	if (!Sources.IsValidIndex(Source) || Component == nullptr || Component == Sources[Source].Field.Get())
+	{
+		return;
+	}
+
+	int32& BodyIndex = BodyIndices.FindOrAdd(Component, INDEX_NONE);
+	if (BodyIndex == INDEX_NONE)
+	{
+		BodyIndex = Bodies.AddDefaulted();
+		Bodies[BodyIndex].Component = Component;
+		Bodies[BodyIndex].Key = Component;
+	}
+	Bodies[BodyIndex].Sources.AddUnique(Source);
+}
+
+void UFPSGravityFieldSubsystem::RemoveMember(int32 Source, UPrimitiveComponent* Component)
+{
+	const int32* BodyIndex = BodyIndices.Find(Component);
+	if (BodyIndex == nullptr)
+	{
+		return;
+	}
+
+	FGravityBody& Body = Bodies[*BodyIndex];
+	Body.Sources.RemoveSingleSwap(Source);
+	if (Body.Sources.Num() == 0)
+	{
+		RemoveBody(*BodyIndex);
+	}
+}
+
+void UFPSGravityFieldSubsystem::RemoveBody(int32 BodyIndex)
+{
+	BodyIndices.Remove(Bodies[BodyIndex].Key);
+	Bodies.RemoveAtSwap(BodyIndex, 1, EAllowShrinking::No);
+	if (Bodies.IsValidIndex(BodyIndex))
+	{
+		BodyIndices.Add(Bodies[BodyIndex].Key, BodyIndex);
+	}
+}
+
+void UFPSGravityFieldSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Bodies.Num() == 0)
+	{
+		return;
+	}
+
+	// Source origins and radii once per frame rather than once per body
+	SourceOrigins.SetNumUninitialized(Sources.GetMaxIndex());
+	SourceRadii.SetNumUninitialized(Sources.GetMaxIndex());
+	for (TSparseArray<FGravitySource>::TConstIterator It(Sources); It; ++It)
+	{
+		const USphereComponent* Field = It->Field.Get();
+		SourceOrigins[It.GetIndex()] = Field ? Field->GetComponentLocation() : FVector::ZeroVector;
+		SourceRadii[It.GetIndex()] = Field ? Field->GetScaledSphereRadius() : 0.0f;
+	}
+
+	for (int32 BodyIndex = Bodies.Num() - 1; BodyIndex >= 0; BodyIndex--)
+	{
+		UPrimitiveComponent* Component = Bodies[BodyIndex].Component.Get();
+		if (Component == nullptr)
+		{
+			RemoveBody(BodyIndex);
+			continue;
+		}
+
+		if (!Component->IsSimulatingPhysics())
+		{
+			continue;
+		}
+
+		const FVector Location = Component->GetCenterOfMass();
+		FVector Acceleration = FVector::ZeroVector;
+		for (const int32 SourceIndex : Bodies[BodyIndex].Sources)
+		{
+			const FGravitySource& Source = Sources[SourceIndex];
+			const FVector Delta = Location - SourceOrigins[SourceIndex];
+			const float Distance = Delta.Size();
+			const float Radius = SourceRadii[SourceIndex];
+			if (Distance > Radius || Distance < UE_KINDA_SMALL_NUMBER)
+			{
+				continue;
+			}
+
+			float Scale = 1.0f;
+			switch (Source.Falloff)
+			{
+			case EFPSGravityFalloff::Linear:
+				Scale = 1.0f - Distance / Radius;
+				break;
+			case EFPSGravityFalloff::InverseSquare:
+				Scale = Distance > Source.CoreRadius ? FMath::Square(Source.CoreRadius / Distance) : 1.0f;
+				break;
+			default:
+				break;
+			}
+
+			// Positive strength pushes away from the source, like AddRadialForce
+			Acceleration += Delta * (Source.Strength * Scale / Distance);
+		}
+
+		if (!Acceleration.IsNearlyZero())
+		{
+			Component->AddForce(Acceleration, NAME_None, true);
+		}
+	}
+}
@@ -0,0 +1,248 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSGuardPerceptionSubsystem.h"
+#include "FPSAIGuard.h"
+#include "Perception/PawnSensingComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "FPSSceneQueries.h"
+#include "Math/VectorRegister.h"
+#include "HAL/PlatformTime.h"
+
+namespace FPSGuardPerception
+{
+	// Coordinate for padding lanes, far outside any sight radius
+	static const float FarAway = 1.0e18f;
+}
+
+bool UFPSGuardPerceptionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFPSGuardPerceptionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSGuardPerceptionSubsystem, STATGROUP_Tickables);
+}
+
+void UFPSGuardPerceptionSubsystem::RegisterGuard(AFPSAIGuard* Guard)
+{
+	if (Guard == nullptr || Guard->GetPawnSensingComponent() == nullptr)
+	{
+		return;
+	}
+
+	Guard->GetPawnSensingComponent()->SetSensingUpdatesEnabled(false);
+
+	FGuardEntry& Entry = Guards.AddDefaulted_GetRef();
+	Entry.Guard = Guard;
+	Entry.SenseTime = GetWorld()->GetTimeSeconds();
+}
+
+void UFPSGuardPerceptionSubsystem::UnregisterGuard(AFPSAIGuard* Guard)
+{
+	// Only cleared here, entries are removed when the next cycle starts so indices stay valid mid-cycle
+	for (FGuardEntry& Entry : Guards)
+	{
+		if (Entry.Guard.Get() == Guard)
+		{
+			Entry.Guard.Reset();
+		}
+	}
+}
+
+void UFPSGuardPerceptionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UWorld* World = GetWorld();
+	if (World->GetNetMode() == NM_Client || Guards.Num() == 0)
+	{
+		return;
+	}
+
+	if (!bCycleActive)
+	{
+		if (World->GetTimeSeconds() - CycleTime < UpdateInterval)
+		{
+			return;
+		}
+		BeginCycle();
+	}
+
+	CycleFrames++;
+
+	const double Deadline = FPlatformTime::Seconds() + BudgetMs * 0.001;
+	do
+	{
+		const int32 LastGuard = FMath::Min(Cursor + FMath::Max(GuardsPerSlice, 1), Guards.Num());
+		ProcessSlice(Cursor, LastGuard);
+		Cursor = LastGuard;
+	} while (Cursor < Guards.Num() && FPlatformTime::Seconds() < Deadline);
+
+	if (Cursor >= Guards.Num())
+	{
+		bCycleActive = false;
+		LastCycleFrames = CycleFrames;
+		LastCycleSeconds = World->GetTimeSeconds() - CycleTime;
+	}
+}
+
+void UFPSGuardPerceptionSubsystem::BeginCycle()
+{
+	using namespace FPSGuardPerception;
+
+	UWorld* World = GetWorld();
+
+	bCycleActive = true;
+	Cursor = 0;
+	CycleTime = World->GetTimeSeconds();
+	CycleFrames = 0;
+
+	Guards.RemoveAll([](const FGuardEntry& Entry) { return !Entry.Guard.IsValid(); });
+
+	CandidatePawns.Reset();
+	CandidateX.Reset();
+	CandidateY.Reset();
+	CandidateZ.Reset();
+	bCandidatePlayer.Reset();
+
+	for (TActorIterator<APawn> It(World); It; ++It)
+	{
+		APawn* Pawn = *It;
+		if (Pawn->IsHidden())
+		{
+			continue;
+		}
+
+		const FVector Location = Pawn->GetActorLocation();
+
+		CandidatePawns.Add(Pawn);
+		CandidateX.Add((float)Location.X);
+		CandidateY.Add((float)Location.Y);
+		CandidateZ.Add((float)Location.Z);
+		bCandidatePlayer.Add(Pawn->IsPlayerControlled());
+	}
+
+	// Pad the culling arrays to whole SIMD registers
+	while (CandidateX.Num() % 4 != 0)
+	{
+		CandidateX.Add(FarAway);
+		CandidateY.Add(FarAway);
+		CandidateZ.Add(FarAway);
+	}
+}
+
+void UFPSGuardPerceptionSubsystem::CullGuard(int32 GuardIndex)
+{
+	AFPSAIGuard* Guard = Guards[GuardIndex].Guard.Get();
+	UPawnSensingComponent* Sensing = Guard ? Guard->GetPawnSensingComponent() : nullptr;
+	if (Sensing == nullptr)
+	{
+		return;
+	}
+
+	// Guards with a longer sensing interval (like distant ones, see UFPSSignificanceSubsystem) sit out some cycles
+	if (CycleTime - Guards[GuardIndex].SenseTime < Sensing->SensingInterval - UE_KINDA_SMALL_NUMBER)
+	{
+		return;
+	}
+
+	Guards[GuardIndex].SenseTime = CycleTime;
+
+	if (!Sensing->bSeePawns)
+	{
+		return;
+	}
+
+	const FVector SensorLocation = Sensing->GetSensorLocation();
+	const FVector Forward = Sensing->GetSensorRotation().Vector();
+
+	const VectorRegister4Float OriginX = VectorSetFloat1((float)SensorLocation.X);
+	const VectorRegister4Float OriginY = VectorSetFloat1((float)SensorLocation.Y);
+	const VectorRegister4Float OriginZ = VectorSetFloat1((float)SensorLocation.Z);
+	const VectorRegister4Float ForwardX = VectorSetFloat1((float)Forward.X);
+	const VectorRegister4Float ForwardY = VectorSetFloat1((float)Forward.Y);
+	const VectorRegister4Float ForwardZ = VectorSetFloat1((float)Forward.Z);
+	const VectorRegister4Float RadiusSq = VectorSetFloat1(FMath::Square(Sensing->SightRadius));
+	const VectorRegister4Float ConeCosine = VectorSetFloat1(Sensing->GetPeripheralVisionCosine());
+
+	for (int32 Base = 0; Base < CandidateX.Num(); Base += 4)
+	{
+		const VectorRegister4Float DeltaX = VectorSubtract(VectorLoad(&CandidateX[Base]), OriginX);
+		const VectorRegister4Float DeltaY = VectorSubtract(VectorLoad(&CandidateY[Base]), OriginY);
+		const VectorRegister4Float DeltaZ = VectorSubtract(VectorLoad(&CandidateZ[Base]), OriginZ);
+
+		const VectorRegister4Float DistanceSq = VectorMultiplyAdd(DeltaZ, DeltaZ, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaX, DeltaX)));
+		const VectorRegister4Float Dot = VectorMultiplyAdd(DeltaZ, ForwardZ, VectorMultiplyAdd(DeltaY, ForwardY, VectorMultiply(DeltaX, ForwardX)));
+
+		// In range, and the angle to the pawn is within the peripheral vision angle
+		const VectorRegister4Float InSight = VectorBitwiseAnd(
+			VectorCompareLE(DistanceSq, RadiusSq),
+			VectorCompareGE(Dot, VectorMultiply(ConeCosine, VectorSqrt(DistanceSq))));
+
+		for (uint32 Lanes = (uint32)VectorMaskBits(InSight); Lanes != 0; Lanes &= Lanes - 1)
+		{
+			const int32 CandidateIndex = Base + (int32)FMath::CountTrailingZeros(Lanes);
+			const APawn* Pawn = CandidatePawns.IsValidIndex(CandidateIndex) ? CandidatePawns[CandidateIndex].Get() : nullptr;
+			if (Pawn == nullptr || Pawn == Guard || (Sensing->bOnlySensePlayers && !bCandidatePlayer[CandidateIndex]))
+			{
+				continue;
+			}
+
+			FPendingTrace& Trace = PendingTraces.AddDefaulted_GetRef();
+			Trace.GuardIndex = GuardIndex;
+			Trace.CandidateIndex = CandidateIndex;
+			Trace.Start = SensorLocation;
+			Trace.End = Pawn->GetActorLocation();
+			Trace.Guard = Guard;
+			Trace.Pawn = Pawn;
+		}
+	}
+}
+
+void UFPSGuardPerceptionSubsystem::ProcessSlice(int32 FirstGuard, int32 LastGuard)
+{
+	PendingTraces.Reset();
+	for (int32 GuardIndex = FirstGuard; GuardIndex < LastGuard; GuardIndex++)
+	{
+		CullGuard(GuardIndex);
+	}
+
+	const int32 TraceNum = PendingTraces.Num();
+	if (TraceNum == 0)
+	{
+		return;
+	}
+
+	// Line of sight for the whole slice
+	UWorld* World = GetWorld();
+	bTraceBlocked.SetNumUninitialized(TraceNum);
+	FPSSceneQueries::ParallelQuery(TraceNum, [this, World](int32 Index)
+	{
+		const FPendingTrace& Trace = PendingTraces[Index];
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FPSGuardPerception), true, Trace.Guard);
+		QueryParams.AddIgnoredActor(Trace.Pawn);
+		bTraceBlocked[Index] = World->LineTraceTestByChannel(Trace.Start, Trace.End, ECC_Visibility, QueryParams);
+	});
+
+	// Deliver on the game thread
+	for (int32 Index = 0; Index < TraceNum; Index++)
+	{
+		if (bTraceBlocked[Index])
+		{
+			continue;
+		}
+
+		// Handlers may have destroyed either side
+		const FPendingTrace& Trace = PendingTraces[Index];
+		AFPSAIGuard* Guard = Guards[Trace.GuardIndex].Guard.Get();
+		APawn* Pawn = CandidatePawns[Trace.CandidateIndex].Get();
+		UPawnSensingComponent* Sensing = Guard ? Guard->GetPawnSensingComponent() : nullptr;
+		if (Sensing && Pawn)
+		{
+			Sensing->OnSeePawn.Broadcast(Pawn);
+		}
+	}
+}
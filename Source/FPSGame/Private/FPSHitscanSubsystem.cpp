@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSHitscanSubsystem.h"
+#include "FPSProjectile.h"
+#include "FPSSceneQueries.h"
+#include "Engine/World.h"
+
+bool UFPSHitscanSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFPSHitscanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSHitscanSubsystem, STATGROUP_Tickables);
+}
+
+const FFPSProjectileTraits& UFPSHitscanSubsystem::FindOrAddType(TSubclassOf<AFPSProjectile> ProjectileClass)
+{
+	if (const FFPSProjectileTraits* Existing = Types.FindByPredicate([ProjectileClass](const FFPSProjectileTraits& Type) { return Type.ProjectileClass == ProjectileClass; }))
+	{
+		return *Existing;
+	}
+	return Types.Add_GetRef(FFPSProjectileTraits::FromClass(ProjectileClass));
+}
+
+void UFPSHitscanSubsystem::QueueShot(TSubclassOf<AFPSProjectile> ProjectileClass, const FVector& Start, const FVector& Direction, float Range, APawn* Instigator)
+{
+	if (!ProjectileClass)
+	{
+		return;
+	}
+
+	const FFPSProjectileTraits& Type = FindOrAddType(ProjectileClass);
+
+	FShot& Shot = Shots.AddDefaulted_GetRef();
+	Shot.Start = Start;
+	Shot.End = Start + Direction * Range;
+	Shot.Velocity = Direction * Type.Speed;
+	Shot.TraceChannel = Type.ObjectType;
+	Shot.Instigator = Instigator;
+	ShotTypeIndices.Add(UE_PTRDIFF_TO_INT32(&Type - Types.GetData()));
+}
+
+void UFPSHitscanSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const int32 ShotNum = Shots.Num();
+	if (ShotNum == 0)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+
+	// Trace all of this frame's shots together
+	Hits.SetNum(ShotNum);
+	bHit.SetNumUninitialized(ShotNum);
+	FPSSceneQueries::ParallelQuery(ShotNum, [this, World](int32 Index)
+	{
+		const FShot& Shot = Shots[Index];
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FPSHitscan), false, Shot.Instigator.Get());
+		bHit[Index] = World->LineTraceSingleByChannel(Hits[Index], Shot.Start, Shot.End, Shot.TraceChannel,
+			QueryParams, Types[ShotTypeIndices[Index]].ResponseParams);
+	});
+
+	// Impacts touch game state, so they stay on the game thread
+	for (int32 Index = 0; Index < ShotNum; Index++)
+	{
+		if (bHit[Index])
+		{
+			const FHitResult& Hit = Hits[Index];
+			AFPSProjectile::ApplyImpact(AFPSProjectile::GetImpactNoiseMaker(World, Hit), Shots[Index].Instigator.Get(), Hit, Shots[Index].Velocity, true);
+		}
+	}
+
+	Shots.Reset();
+	ShotTypeIndices.Reset();
+}
@@ -13,8 +13,8 @@ const float AFPSLauchPad::LAUCH_PAD_SIZE = 50.0f;
 // Sets default values
 AFPSLauchPad::AFPSLauchPad()
 {
-	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Nothing to do per frame
+	PrimaryActorTick.bCanEverTick = false;
 
 	OverlapComp = CreateDefaultSubobject<UBoxComponent>(TEXT("OverlapComp"));
 	OverlapComp->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSNetBenchmarkSubsystem.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "Engine/ReplicationDriver.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformTime.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+
+bool UFPSNetBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UFPSNetBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	float CommandLineDuration = 0.0f;
+	return Super::ShouldCreateSubsystem(Outer) && FParse::Value(FCommandLine::Get(), TEXT("FPSNetBenchmark="), CommandLineDuration);
+}
+
+TStatId UFPSNetBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSNetBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+void UFPSNetBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FParse::Value(FCommandLine::Get(), TEXT("FPSNetBenchmark="), Duration);
+	FParse::Value(FCommandLine::Get(), TEXT("FPSNetBenchmarkWarmup="), WarmupSeconds);
+	FParse::Value(FCommandLine::Get(), TEXT("FPSNetBenchmarkClients="), ExpectedClientNum);
+}
+
+void UFPSNetBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UWorld* World = GetWorld();
+	const UNetDriver* NetDriver = World->GetNetDriver();
+	if (NetDriver == nullptr || !NetDriver->IsServer() || Phase == EPhase::Done)
+	{
+		return;
+	}
+
+	const int32 ClientNum = NetDriver->ClientConnections.Num();
+	const double Now = FPlatformTime::Seconds();
+
+	switch (Phase)
+	{
+	case EPhase::WaitingForClients:
+		if (ClientNum >= ExpectedClientNum)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Net benchmark: %d clients connected, warming up for %.0f s"), ClientNum, WarmupSeconds);
+			Phase = EPhase::Warmup;
+			PhaseStartTime = Now;
+		}
+		break;
+
+	case EPhase::Warmup:
+		if (Now - PhaseStartTime >= WarmupSeconds)
+		{
+			BeginSampling(NetDriver);
+		}
+		break;
+
+	case EPhase::Sampling:
+		// Busy time only. A dedicated server sleeps out the rest of each frame to hold its tick rate
+		ServerMs.Add((float)(FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0) * 1000.0));
+		MinClientNum = FMath::Min(MinClientNum, ClientNum);
+		MaxClientNum = FMath::Max(MaxClientNum, ClientNum);
+
+		if (Now - PhaseStartTime >= Duration)
+		{
+			WriteReport(NetDriver);
+			Phase = EPhase::Done;
+			FPlatformMisc::RequestExit(false);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+void UFPSNetBenchmarkSubsystem::BeginSampling(const UNetDriver* NetDriver)
+{
+	UE_LOG(LogTemp, Log, TEXT("Net benchmark: sampling for %.0f s"), Duration);
+
+	Phase = EPhase::Sampling;
+	PhaseStartTime = FPlatformTime::Seconds();
+
+	StartOutBytes = NetDriver->OutTotalBytes;
+	StartInBytes = NetDriver->InTotalBytes;
+	StartOutPackets = NetDriver->OutTotalPackets;
+
+	ServerMs.Reset();
+	MinClientNum = NetDriver->ClientConnections.Num();
+	MaxClientNum = MinClientNum;
+}
+
+void UFPSNetBenchmarkSubsystem::WriteReport(const UNetDriver* NetDriver)
+{
+	const double Seconds = FMath::Max(FPlatformTime::Seconds() - PhaseStartTime, UE_KINDA_SMALL_NUMBER);
+
+	// Unsigned subtraction, so the totals wrapping around doesn't matter
+	const uint32 OutBytes = (uint32)NetDriver->OutTotalBytes - StartOutBytes;
+	const uint32 InBytes = (uint32)NetDriver->InTotalBytes - StartInBytes;
+	const uint32 OutPackets = (uint32)NetDriver->OutTotalPackets - StartOutPackets;
+
+	const double OutKBytesPerSecond = OutBytes / 1024.0 / Seconds;
+
+	TArray<float> SortedMs = ServerMs;
+	SortedMs.Sort();
+	double TotalMs = 0.0;
+	for (const float Ms : SortedMs)
+	{
+		TotalMs += Ms;
+	}
+	const int32 FrameNum = SortedMs.Num();
+
+	const UReplicationDriver* ReplicationDriver = NetDriver->GetReplicationDriver();
+	const FString ReplicationDriverName = ReplicationDriver ? ReplicationDriver->GetClass()->GetName() : TEXT("None");
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("test"), TEXT("NetBenchmark"));
+	Report->SetStringField(TEXT("map"), GetWorld()->GetMapName());
+	Report->SetStringField(TEXT("replication_driver"), ReplicationDriverName);
+	Report->SetNumberField(TEXT("seconds"), Seconds);
+	Report->SetNumberField(TEXT("min_clients"), MinClientNum);
+	Report->SetNumberField(TEXT("max_clients"), MaxClientNum);
+	Report->SetNumberField(TEXT("out_kbytes_per_sec"), OutKBytesPerSecond);
+	Report->SetNumberField(TEXT("out_kbytes_per_sec_per_client"), MaxClientNum > 0 ? OutKBytesPerSecond / MaxClientNum : 0.0);
+	Report->SetNumberField(TEXT("in_kbytes_per_sec"), InBytes / 1024.0 / Seconds);
+	Report->SetNumberField(TEXT("out_packets_per_sec"), OutPackets / Seconds);
+
+	TSharedRef<FJsonObject> ServerReport = MakeShared<FJsonObject>();
+	ServerReport->SetNumberField(TEXT("frames"), FrameNum);
+	ServerReport->SetNumberField(TEXT("mean"), FrameNum > 0 ? TotalMs / FrameNum : 0.0);
+	ServerReport->SetNumberField(TEXT("p95"), FrameNum > 0 ? SortedMs[FMath::Min(FMath::FloorToInt32(FrameNum * 0.95f), FrameNum - 1)] : 0.0);
+	ServerReport->SetNumberField(TEXT("max"), FrameNum > 0 ? SortedMs.Last() : 0.0);
+	Report->SetObjectField(TEXT("server_ms"), ServerReport);
+
+	FString ReportString;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ReportString);
+	FJsonSerializer::Serialize(Report, Writer);
+
+	FString Dir = FPaths::ProjectSavedDir() / TEXT("NetBenchmark");
+	FParse::Value(FCommandLine::Get(), TEXT("FPSNetBenchmarkOutputDir="), Dir);
+	const FString FileName = FString::Printf(TEXT("NetBenchmark_%s_%d.json"), *ReplicationDriverName, MaxClientNum);
+	FFileHelper::SaveStringToFile(ReportString, *(Dir / FileName));
+
+	UE_LOG(LogTemp, Log, TEXT("Net benchmark (%s, %d clients): %.1f KB/s out (%.2f per client), server %.2f ms mean, written to %s"),
+		*ReplicationDriverName, MaxClientNum, OutKBytesPerSecond, MaxClientNum > 0 ? OutKBytesPerSecond / MaxClientNum : 0.0,
+		FrameNum > 0 ? TotalMs / FrameNum : 0.0, *(Dir / FileName));
+}
@@ -0,0 +1,295 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSNoiseSubsystem.h"
+#include "Perception/PawnSensingComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "FPSSceneQueries.h"
+#include "HAL/IConsoleManager.h"
+
+int32 UFPSNoiseSubsystem::RoutedWorldNum = 0;
+FMakeNoiseDelegate UFPSNoiseSubsystem::ChainedMakeNoise = FMakeNoiseDelegate::CreateStatic(&AActor::MakeNoiseImpl);
+
+static FAutoConsoleCommandWithWorld NoiseStatsCommand(
+	TEXT("FPS.Noise.Stats"),
+	TEXT("Logs the noise events, candidate checks and deliveries so far"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UFPSNoiseSubsystem* Noise = World ? World->GetSubsystem<UFPSNoiseSubsystem>() : nullptr)
+		{
+			Noise->LogStats();
+		}
+	}));
+
+bool UFPSNoiseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFPSNoiseSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSNoiseSubsystem, STATGROUP_Tickables);
+}
+
+void UFPSNoiseSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// The delegate is global, so it stays routed while any world has a noise subsystem
+	if (RoutedWorldNum++ == 0)
+	{
+		AActor::SetMakeNoiseDelegate(FMakeNoiseDelegate::CreateStatic(&UFPSNoiseSubsystem::RouteMakeNoise));
+	}
+}
+
+void UFPSNoiseSubsystem::Deinitialize()
+{
+	if (--RoutedWorldNum == 0)
+	{
+		AActor::SetMakeNoiseDelegate(ChainedMakeNoise);
+	}
+
+	Super::Deinitialize();
+}
+
+void UFPSNoiseSubsystem::SetMakeNoiseDelegate(const FMakeNoiseDelegate& NewDelegate)
+{
+	if (!NewDelegate.IsBound())
+	{
+		return;
+	}
+
+	ChainedMakeNoise = NewDelegate;
+	if (RoutedWorldNum == 0)
+	{
+		AActor::SetMakeNoiseDelegate(NewDelegate);
+	}
+}
+
+void UFPSNoiseSubsystem::RouteMakeNoise(AActor* NoiseMaker, float Loudness, APawn* NoiseInstigator, const FVector& NoiseLocation, float MaxRange, FName Tag)
+{
+	// Whatever was installed before, by default MakeNoiseImpl, which keeps updating the pawn noise emitters for
+	// sensing components that still poll them
+	ChainedMakeNoise.ExecuteIfBound(NoiseMaker, Loudness, NoiseInstigator, NoiseLocation, MaxRange, Tag);
+
+	UWorld* World = NoiseMaker ? NoiseMaker->GetWorld() : nullptr;
+	if (UFPSNoiseSubsystem* Noise = World ? World->GetSubsystem<UFPSNoiseSubsystem>() : nullptr)
+	{
+		Noise->ReportNoise(NoiseMaker, NoiseInstigator, NoiseLocation, Loudness, MaxRange);
+	}
+}
+
+FIntPoint UFPSNoiseSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void UFPSNoiseSubsystem::RegisterListener(UPawnSensingComponent* Sensing)
+{
+	if (Sensing == nullptr)
+	{
+		return;
+	}
+
+	Listeners.AddUnique(Sensing);
+	MaxHearingRange = FMath::Max3(MaxHearingRange, Sensing->HearingThreshold, Sensing->LOSHearingThreshold);
+}
+
+void UFPSNoiseSubsystem::UnregisterListener(UPawnSensingComponent* Sensing)
+{
+	Listeners.RemoveSingleSwap(Sensing);
+}
+
+void UFPSNoiseSubsystem::ReportNoise(AActor* NoiseMaker, APawn* NoiseInstigator, const FVector& Location, float Loudness, float MaxRange)
+{
+	// Like AActor::MakeNoiseImpl, noise without an instigating pawn can't be heard
+	APawn* Instigator = NoiseInstigator ? NoiseInstigator : (NoiseMaker ? NoiseMaker->GetInstigator() : nullptr);
+	if (Instigator == nullptr || Loudness <= 0.0f || MaxHearingRange <= 0.0f || GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	const int32 EventIndex = Events.Num();
+	FNoiseEvent& Event = Events.AddDefaulted_GetRef();
+	Event.Location = Location;
+	Event.Loudness = Loudness;
+	Event.MaxRange = MaxRange;
+	Event.Instigator = Instigator;
+	Event.NoiseMaker = NoiseMaker;
+	EventNum++;
+
+	float Radius = Loudness * MaxHearingRange;
+	if (MaxRange > 0.0f)
+	{
+		Radius = FMath::Min(Radius, MaxRange);
+	}
+
+	const FIntPoint MinCell = GetCell(Location - FVector(Radius, Radius, 0.0f));
+	const FIntPoint MaxCell = GetCell(Location + FVector(Radius, Radius, 0.0f));
+	if ((int64)(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) > MaxCellsPerNoise)
+	{
+		UnbucketedEvents.Add(EventIndex);
+		return;
+	}
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			Cells.FindOrAdd(FIntPoint(X, Y)).Add(EventIndex);
+		}
+	}
+}
+
+void UFPSNoiseSubsystem::ConsiderEvent(const UPawnSensingComponent* Sensing, const FVector& SensorLocation, int32 EventIndex,
+	int32& InOutBest, float& InOutBestScore, bool& bInOutBestThroughWalls) const
+{
+	const FNoiseEvent& Event = DeliveryEvents[EventIndex];
+	const APawn* Instigator = Event.Instigator.Get();
+	if (Instigator == nullptr || Instigator == Sensing->GetOwner() || (Sensing->bOnlySensePlayers && !Instigator->IsPlayerControlled()))
+	{
+		return;
+	}
+
+	const float DistanceSq = FVector::DistSquared(Event.Location, SensorLocation);
+	if (Event.MaxRange > 0.0f && DistanceSq > FMath::Square(Event.MaxRange))
+	{
+		return;
+	}
+
+	// Heard regardless of occlusion within HearingThreshold, with line of sight within LOSHearingThreshold
+	const bool bThroughWalls = DistanceSq <= FMath::Square(Sensing->HearingThreshold * Event.Loudness);
+	if (!bThroughWalls && DistanceSq > FMath::Square(Sensing->LOSHearingThreshold * Event.Loudness))
+	{
+		return;
+	}
+
+	// Distance relative to loudness, so a loud distant noise can beat a quiet close one
+	const float Score = DistanceSq / FMath::Square(Event.Loudness);
+	if (InOutBest == INDEX_NONE || (bThroughWalls && !bInOutBestThroughWalls) || (bThroughWalls == bInOutBestThroughWalls && Score < InOutBestScore))
+	{
+		InOutBest = EventIndex;
+		InOutBestScore = Score;
+		bInOutBestThroughWalls = bThroughWalls;
+	}
+}
+
+void UFPSNoiseSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Noise reported while this frame's is delivered goes out next frame
+	Swap(Events, DeliveryEvents);
+	Swap(Cells, DeliveryCells);
+	Swap(UnbucketedEvents, DeliveryUnbucketedEvents);
+
+	Events.Reset();
+	UnbucketedEvents.Reset();
+	if (Cells.Num() > 4096)
+	{
+		Cells.Reset();
+	}
+	else
+	{
+		// Keep the cells' allocations, noise tends to come from the same places
+		for (TPair<FIntPoint, TArray<int32>>& Cell : Cells)
+		{
+			Cell.Value.Reset();
+		}
+	}
+
+	if (DeliveryEvents.Num() == 0)
+	{
+		return;
+	}
+
+	Listeners.RemoveAllSwap([](const TWeakObjectPtr<UPawnSensingComponent>& Listener) { return !Listener.IsValid(); });
+
+	PendingNoises.Reset();
+	for (const TWeakObjectPtr<UPawnSensingComponent>& Listener : Listeners)
+	{
+		const UPawnSensingComponent* Sensing = Listener.Get();
+		if (!Sensing->bHearNoises)
+		{
+			continue;
+		}
+
+		const FVector SensorLocation = Sensing->GetSensorLocation();
+		int32 Best = INDEX_NONE;
+		float BestScore = 0.0f;
+		bool bBestThroughWalls = false;
+
+		if (const TArray<int32>* Cell = DeliveryCells.Find(GetCell(SensorLocation)))
+		{
+			CandidateChecks += Cell->Num();
+			for (const int32 EventIndex : *Cell)
+			{
+				ConsiderEvent(Sensing, SensorLocation, EventIndex, Best, BestScore, bBestThroughWalls);
+			}
+		}
+		CandidateChecks += DeliveryUnbucketedEvents.Num();
+		for (const int32 EventIndex : DeliveryUnbucketedEvents)
+		{
+			ConsiderEvent(Sensing, SensorLocation, EventIndex, Best, BestScore, bBestThroughWalls);
+		}
+
+		if (Best != INDEX_NONE)
+		{
+			FPendingNoise& Pending = PendingNoises.AddDefaulted_GetRef();
+			Pending.Listener = Listener;
+			Pending.EventIndex = Best;
+			Pending.Start = SensorLocation;
+			Pending.Owner = Sensing->GetOwner();
+			Pending.bTrace = !bBestThroughWalls;
+		}
+	}
+
+	// Line of sight for every listener at once
+	UWorld* World = GetWorld();
+	const int32 PendingNum = PendingNoises.Num();
+	bTraceBlocked.SetNumUninitialized(PendingNum);
+	FPSSceneQueries::ParallelQuery(PendingNum, [this, World](int32 Index)
+	{
+		const FPendingNoise& Pending = PendingNoises[Index];
+		if (!Pending.bTrace)
+		{
+			bTraceBlocked[Index] = false;
+			return;
+		}
+
+		const FNoiseEvent& Event = DeliveryEvents[Pending.EventIndex];
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FPSNoise), true, Pending.Owner);
+		QueryParams.AddIgnoredActor(Event.Instigator.Get());
+		QueryParams.AddIgnoredActor(Event.NoiseMaker.Get());
+
+		// Stop just short of the noise, which is often on the surface that made it
+		const FVector End = Event.Location + (Pending.Start - Event.Location).GetSafeNormal() * 10.0f;
+		bTraceBlocked[Index] = World->LineTraceTestByChannel(Pending.Start, End, ECC_Visibility, QueryParams);
+	});
+
+	for (int32 Index = 0; Index < PendingNum; Index++)
+	{
+		if (bTraceBlocked[Index])
+		{
+			continue;
+		}
+
+		// Handlers may have destroyed either side
+		const FPendingNoise& Pending = PendingNoises[Index];
+		const FNoiseEvent& Event = DeliveryEvents[Pending.EventIndex];
+		UPawnSensingComponent* Sensing = Pending.Listener.Get();
+		APawn* Instigator = Event.Instigator.Get();
+		if (Sensing && Instigator)
+		{
+			DeliveredNum++;
+			Sensing->OnHearNoise.Broadcast(Instigator, Event.Location, Event.Loudness);
+		}
+	}
+}
+
+void UFPSNoiseSubsystem::LogStats() const
+{
+	UE_LOG(LogTemp, Log, TEXT("Noise: %d listeners, %lld events, %lld candidate checks (%.1f per event), %lld delivered"),
+		Listeners.Num(), EventNum, CandidateChecks, EventNum > 0 ? (double)CandidateChecks / EventNum : 0.0, DeliveredNum);
+}
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSPatrolRoute.h"
+#include "Components/SplineComponent.h"
+
+// Sets default values
+AFPSPatrolRoute::AFPSPatrolRoute()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	SplineComp = CreateDefaultSubobject<USplineComponent>(TEXT("SplineComp"));
+	RootComponent = SplineComp;
+}
+
+void AFPSPatrolRoute::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	SplineComp->SetClosedLoop(bLoop);
+	CacheWaypoints();
+}
+
+void AFPSPatrolRoute::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	CacheWaypoints();
+}
+
+void AFPSPatrolRoute::CacheWaypoints()
+{
+	Waypoints.Reset();
+	for (int32 PointIndex = 0; PointIndex < SplineComp->GetNumberOfSplinePoints(); PointIndex++)
+	{
+		Waypoints.Add(SplineComp->GetLocationAtSplinePoint(PointIndex, ESplineCoordinateSpace::World));
+	}
+}
+
+int32 AFPSPatrolRoute::FindNearestWaypoint(const FVector& Location) const
+{
+	int32 Nearest = INDEX_NONE;
+	float NearestDistanceSq = MAX_flt;
+	for (int32 Index = 0; Index < Waypoints.Num(); Index++)
+	{
+		const float DistanceSq = FVector::DistSquared(Waypoints[Index], Location);
+		if (DistanceSq < NearestDistanceSq)
+		{
+			Nearest = Index;
+			NearestDistanceSq = DistanceSq;
+		}
+	}
+	return Nearest;
+}
+
+int32 AFPSPatrolRoute::GetNextWaypoint(int32 Current, int32& InOutDirection, const FVector& Location) const
+{
+	const int32 WaypointNum = Waypoints.Num();
+	if (!Waypoints.IsValidIndex(Current))
+	{
+		return FindNearestWaypoint(Location);
+	}
+
+	if (WaypointNum == 1)
+	{
+		return Current;
+	}
+
+	if (bLoop)
+	{
+		return (Current + 1) % WaypointNum;
+	}
+
+	// Ping-pong
+	if (!Waypoints.IsValidIndex(Current + InOutDirection))
+	{
+		InOutDirection = -InOutDirection;
+	}
+	return Current + InOutDirection;
+}
@@ -2,9 +2,12 @@
 
 #include "FPSPlayerController.h"
 #include "FPSSpectatorCamera.h"
+#include "FPSCharacter.h"
+#include "Engine/Engine.h"
 #include "Engine/World.h"
 #include "Components/InputComponent.h"
 #include "GameFramework/Pawn.h"
+#include "Misc/CommandLine.h"
 
 AFPSPlayerController::AFPSPlayerController()
 {
@@ -37,6 +40,68 @@ void AFPSPlayerController::BeginPlay()
 			UE_LOG(LogTemp, Warning, TEXT("Failed to create spectator camera"));
 		}
 	}
+
+	if (IsLocalController() && GetNetMode() == NM_Client && FParse::Param(FCommandLine::Get(), TEXT("FPSBotClient")))
+	{
+		bBotClient = true;
+		BotNetworkFailureHandle = GEngine->OnNetworkFailure().AddUObject(this, &AFPSPlayerController::OnBotNetworkFailure);
+		UE_LOG(LogTemp, Log, TEXT("Running as a bot client"));
+	}
+}
+
+void AFPSPlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (BotNetworkFailureHandle.IsValid())
+	{
+		GEngine->OnNetworkFailure().Remove(BotNetworkFailureHandle);
+		BotNetworkFailureHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AFPSPlayerController::PlayerTick(float DeltaTime)
+{
+	Super::PlayerTick(DeltaTime);
+
+	if (bBotClient)
+	{
+		UpdateBot(DeltaTime);
+	}
+}
+
+void AFPSPlayerController::UpdateBot(float DeltaTime)
+{
+	AFPSCharacter* BotCharacter = Cast<AFPSCharacter>(GetPawn());
+	if (BotCharacter == nullptr)
+	{
+		return;
+	}
+
+	BotTurnTimer -= DeltaTime;
+	if (BotTurnTimer <= 0.0f)
+	{
+		BotTurnTimer = BotTurnInterval * FMath::FRandRange(0.5f, 1.5f);
+		BotTurnRate = FMath::FRandRange(-1.0f, 1.0f);
+	}
+
+	// Turning keeps it from staying stuck against walls
+	AddYawInput(BotTurnRate * BotMaxTurnRate * DeltaTime);
+	BotCharacter->AddMovementInput(BotCharacter->GetActorForwardVector(), 1.0f);
+
+	BotFireTimer -= DeltaTime;
+	if (BotFireTimer <= 0.0f)
+	{
+		BotFireTimer = BotFireInterval;
+		BotCharacter->Fire();
+	}
+}
+
+void AFPSPlayerController::OnBotNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString)
+{
+	// The benchmark server quits when it is done, which is the bot's cue to quit as well
+	UE_LOG(LogTemp, Log, TEXT("Bot client lost the server (%s), quitting"), *ErrorString);
+	FPlatformMisc::RequestExit(false);
 }
 
 void AFPSPlayerController::SetupInputComponent()
@@ -3,6 +3,10 @@
 #include "FPSProjectile.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
+#include "FPSProjectilePoolSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Net/UnrealNetwork.h"
 
 AFPSProjectile::AFPSProjectile()
 {
@@ -37,15 +41,127 @@ AFPSProjectile::AFPSProjectile()
 
 void AFPSProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
-	// Only add impulse and destroy projectile if we hit a physics
-	if ((OtherActor != NULL) && (OtherActor != this) && (OtherComp != NULL) && OtherComp->IsSimulatingPhysics())
+	if (OtherActor == this)
 	{
-		OtherComp->AddImpulseAtLocation(GetVelocity() * 100.0f, GetActorLocation());
+		return;
 	}
 
+	FHitResult ImpactHit = Hit;
+	ImpactHit.Location = GetActorLocation();
+	ApplyImpact(this, GetInstigator(), ImpactHit, GetVelocity(), GetLocalRole() == ROLE_Authority);
+
 	if (GetLocalRole() == ROLE_Authority) {
-		MakeNoise(1.0f, GetInstigator());
+		Expire();
+	}
+
+}
+
+void AFPSProjectile::ApplyImpact(AActor* NoiseMaker, APawn* NoiseInstigator, const FHitResult& Hit, const FVector& Velocity, bool bAuthority)
+{
+	// Only add impulse if we hit a physics
+	UPrimitiveComponent* OtherComp = Hit.GetComponent();
+	if ((Hit.GetActor() != NULL) && (OtherComp != NULL) && OtherComp->IsSimulatingPhysics())
+	{
+		OtherComp->AddImpulseAtLocation(Velocity * 100.0f, Hit.Location);
+	}
+
+	if (bAuthority && NoiseMaker) {
+		NoiseMaker->MakeNoise(1.0f, NoiseInstigator, Hit.Location);
+	}
+}
+
+AActor* AFPSProjectile::GetImpactNoiseMaker(UWorld* World, const FHitResult& Hit)
+{
+	AActor* HitActor = Hit.GetActor();
+	return HitActor && !HitActor->IsA<APawn>() ? HitActor : World->GetWorldSettings();
+}
+
+FFPSProjectileTraits FFPSProjectileTraits::FromClass(TSubclassOf<AFPSProjectile> ProjectileClass)
+{
+	const AFPSProjectile* Defaults = ProjectileClass->GetDefaultObject<AFPSProjectile>();
+
+	FFPSProjectileTraits Traits;
+	Traits.ProjectileClass = ProjectileClass;
+	Traits.Radius = Defaults->GetCollisionComp()->GetUnscaledSphereRadius();
+	Traits.Speed = Defaults->GetProjectileMovement()->InitialSpeed;
+	Traits.GravityScale = Defaults->GetProjectileMovement()->ProjectileGravityScale;
+	Traits.LifeSpan = Defaults->InitialLifeSpan;
+	Traits.ObjectType = Defaults->GetCollisionComp()->GetCollisionObjectType();
+	Traits.ResponseParams = FCollisionResponseParams(Defaults->GetCollisionComp()->GetCollisionResponseToChannels());
+	return Traits;
+}
+
+void AFPSProjectile::LifeSpanExpired()
+{
+	if (bPooled)
+	{
+		Expire();
+		return;
+	}
+
+	Super::LifeSpanExpired();
+}
+
+void AFPSProjectile::Expire()
+{
+	UFPSProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UFPSProjectilePoolSubsystem>();
+	if (bPooled && Pool)
+	{
+		Pool->Release(this);
+	}
+	else
+	{
 		Destroy();
 	}
+}
+
+void AFPSProjectile::ActivateFromPool(const FVector& Location, const FRotator& Rotation, APawn* InInstigator)
+{
+	bParked = false;
+	SetNetDormancy(DORM_Awake);
+	SetInstigator(InInstigator);
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+	ApplyParked();
+
+	SetLifeSpan(InitialLifeSpan);
+}
+
+void AFPSProjectile::DeactivateForPool()
+{
+	bParked = true;
+	SetLifeSpan(0.0f);
+	ApplyParked();
+
+	// Clients get the parked state one last time, then nothing until it is fired again
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AFPSProjectile::OnRep_Parked()
+{
+	ApplyParked();
+}
+
+void AFPSProjectile::ApplyParked()
+{
+	SetActorHiddenInGame(bParked);
+	SetActorEnableCollision(!bParked);
+
+	if (bParked)
+	{
+		ProjectileMovement->StopMovementImmediately();
+		ProjectileMovement->Deactivate();
+		return;
+	}
+
+	// Stopping clears the updated component, so hook it up again before launching
+	ProjectileMovement->SetUpdatedComponent(CollisionComp);
+	ProjectileMovement->Velocity = GetActorForwardVector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->Activate(true);
+}
+
+void AFPSProjectile::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
+	DOREPLIFETIME(AFPSProjectile, bParked);
 }
\ No newline at end of file
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSProjectileFireEvent.h"
+#include "Engine/NetSerialization.h"
+#include "Math/RandomStream.h"
+
+FVector FFPSProjectileFireEvent::GetSpreadDirection(float SpreadDegrees) const
+{
+	if (SpreadDegrees <= 0.0f)
+	{
+		return Direction;
+	}
+
+	FRandomStream Stream(Seed);
+	return Stream.VRandCone(Direction, FMath::DegreesToRadians(SpreadDegrees));
+}
+
+void FFPSProjectileFireEvent::CompressDirection(const FVector& InDirection, uint16& OutYaw, uint16& OutPitch)
+{
+	const FRotator Rotation = InDirection.Rotation();
+	OutYaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+	OutPitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+}
+
+FVector FFPSProjectileFireEvent::DecompressDirection(uint16 Yaw, uint16 Pitch)
+{
+	return FRotator(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), 0.0f).Vector();
+}
+
+void FFPSProjectileFireEvent::Quantize()
+{
+	// SerializePackedVector<1, N> rounds each component to the nearest integer
+	Origin = FVector(FMath::RoundToInt(Origin.X), FMath::RoundToInt(Origin.Y), FMath::RoundToInt(Origin.Z));
+
+	uint16 Yaw = 0;
+	uint16 Pitch = 0;
+	CompressDirection(Direction, Yaw, Pitch);
+	Direction = DecompressDirection(Yaw, Pitch);
+}
+
+bool FFPSProjectileFireEvent::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	// Whole centimetres, like FVector_NetQuantize
+	bOutSuccess = SerializePackedVector<1, 20>(Origin, Ar);
+
+	// Yaw and pitch at 16 bits each instead of three components
+	uint16 Yaw = 0;
+	uint16 Pitch = 0;
+	if (Ar.IsSaving())
+	{
+		CompressDirection(Direction, Yaw, Pitch);
+	}
+	Ar << Yaw;
+	Ar << Pitch;
+	if (Ar.IsLoading())
+	{
+		Direction = DecompressDirection(Yaw, Pitch);
+	}
+
+	Ar << Time;
+	Ar << Seed;
+
+	return true;
+}
@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSProjectilePoolSubsystem.h"
+#include "FPSProjectile.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommandWithWorld ProjectilePoolStatsCommand(
+	TEXT("FPS.ProjectilePool.Stats"),
+	TEXT("Logs occupancy and miss counts of the projectile pools"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UFPSProjectilePoolSubsystem* Pool = World ? World->GetSubsystem<UFPSProjectilePoolSubsystem>() : nullptr)
+		{
+			Pool->LogStats();
+		}
+	}));
+
+bool UFPSProjectilePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFPSProjectilePoolSubsystem::Deinitialize()
+{
+	LogStats();
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+void UFPSProjectilePoolSubsystem::Prewarm(TSubclassOf<AFPSProjectile> ProjectileClass, int32 Count)
+{
+	if (!ProjectileClass)
+	{
+		return;
+	}
+
+	FFPSProjectilePool& Pool = Pools.FindOrAdd(ProjectileClass);
+	for (int32 Idx = Pool.Pooled.Num() + Pool.ActiveNum; Idx < FMath::Min(Count, MaxPooledPerClass); Idx++)
+	{
+		if (AFPSProjectile* Projectile = SpawnPooled(ProjectileClass))
+		{
+			Pool.Pooled.Add(Projectile);
+		}
+	}
+}
+
+AFPSProjectile* UFPSProjectilePoolSubsystem::SpawnPooled(TSubclassOf<AFPSProjectile> ProjectileClass)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AFPSProjectile* Projectile = GetWorld()->SpawnActor<AFPSProjectile>(ProjectileClass, FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+	if (Projectile)
+	{
+		Projectile->bPooled = true;
+		Projectile->DeactivateForPool();
+	}
+	return Projectile;
+}
+
+AFPSProjectile* UFPSProjectilePoolSubsystem::Acquire(TSubclassOf<AFPSProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* Instigator)
+{
+	if (!ProjectileClass)
+	{
+		return nullptr;
+	}
+
+	FFPSProjectilePool& Pool = Pools.FindOrAdd(ProjectileClass);
+	Pool.AcquireNum++;
+
+	AFPSProjectile* Projectile = nullptr;
+	while (Pool.Pooled.Num() > 0 && Projectile == nullptr)
+	{
+		// Level streaming or world teardown can destroy a pooled projectile, which nulls or invalidates its entry
+		AFPSProjectile* Candidate = Pool.Pooled.Pop(EAllowShrinking::No);
+		Projectile = IsValid(Candidate) ? Candidate : nullptr;
+	}
+
+	if (Projectile == nullptr)
+	{
+		Pool.MissNum++;
+		Projectile = SpawnPooled(ProjectileClass);
+		if (Projectile == nullptr)
+		{
+			return nullptr;
+		}
+	}
+
+	Pool.ActiveNum++;
+	Pool.PeakActiveNum = FMath::Max(Pool.PeakActiveNum, Pool.ActiveNum);
+
+	Projectile->ActivateFromPool(Location, Rotation, Instigator);
+	return Projectile;
+}
+
+void UFPSProjectilePoolSubsystem::Release(AFPSProjectile* Projectile)
+{
+	if (Projectile == nullptr || !Projectile->IsActiveInPool())
+	{
+		return;
+	}
+
+	Projectile->DeactivateForPool();
+
+	FFPSProjectilePool& Pool = Pools.FindOrAdd(Projectile->GetClass());
+	Pool.ActiveNum = FMath::Max(Pool.ActiveNum - 1, 0);
+
+	if (Pool.Pooled.Num() >= MaxPooledPerClass)
+	{
+		Pool.OverflowNum++;
+		Projectile->Destroy();
+		return;
+	}
+	Pool.Pooled.Add(Projectile);
+}
+
+void UFPSProjectilePoolSubsystem::LogStats() const
+{
+	for (const TPair<TSubclassOf<AFPSProjectile>, FFPSProjectilePool>& Pair : Pools)
+	{
+		const FFPSProjectilePool& Pool = Pair.Value;
+		UE_LOG(LogTemp, Log, TEXT("ProjectilePool %s: %d active (peak %d), %d pooled, %d acquires, %d misses (%.1f%%), %d overflow"),
+			*GetNameSafe(Pair.Key), Pool.ActiveNum, Pool.PeakActiveNum, Pool.Pooled.Num(), Pool.AcquireNum, Pool.MissNum,
+			Pool.AcquireNum > 0 ? 100.0f * Pool.MissNum / Pool.AcquireNum : 0.0f, Pool.OverflowNum);
+	}
+}
@@ -0,0 +1,253 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSProjectileSimulationSubsystem.h"
+#include "FPSProjectile.h"
+#include "FPSProjectileFireEvent.h"
+#include "FPSCharacter.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Engine/World.h"
+#include "FPSSceneQueries.h"
+#include "DrawDebugHelpers.h"
+#include "HAL/IConsoleManager.h"
+
+static int32 GFPSProjectileSimDebug = 0;
+static FAutoConsoleVariableRef CVarFPSProjectileSimDebug(
+	TEXT("FPS.ProjectileSim.Debug"),
+	GFPSProjectileSimDebug,
+	TEXT("Draw simulated projectiles"));
+
+bool UFPSProjectileSimulationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFPSProjectileSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSProjectileSimulationSubsystem, STATGROUP_Tickables);
+}
+
+int32 UFPSProjectileSimulationSubsystem::FindOrAddType(TSubclassOf<AFPSProjectile> ProjectileClass)
+{
+	const int32 Existing = Types.IndexOfByPredicate([ProjectileClass](const FFPSProjectileTraits& Type) { return Type.ProjectileClass == ProjectileClass; });
+	if (Existing != INDEX_NONE)
+	{
+		return Existing;
+	}
+
+	const FFPSProjectileTraits& Type = Types[Types.Add(FFPSProjectileTraits::FromClass(ProjectileClass))];
+
+	FCollisionResponseParams& Cosmetic = CosmeticResponseParams.Add_GetRef(Type.ResponseParams);
+	const ECollisionResponse StaticResponse = Cosmetic.CollisionResponse.GetResponse(ECC_WorldStatic);
+	Cosmetic.CollisionResponse.SetAllChannels(ECR_Ignore);
+	Cosmetic.CollisionResponse.SetResponse(ECC_WorldStatic, StaticResponse);
+
+	return Types.Num() - 1;
+}
+
+void UFPSProjectileSimulationSubsystem::Fire(TSubclassOf<AFPSProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* Instigator)
+{
+	if (!ProjectileClass)
+	{
+		return;
+	}
+
+	AddProjectile(FindOrAddType(ProjectileClass), Location, Rotation.Vector(), Instigator, EProjectileKind::Authoritative, 0, 0.0f);
+}
+
+void UFPSProjectileSimulationSubsystem::FirePredicted(TSubclassOf<AFPSProjectile> ProjectileClass, const FFPSProjectileFireEvent& FireEvent, APawn* Instigator,
+	float SpreadDegrees, float Advance, bool bCosmetic)
+{
+	if (!ProjectileClass)
+	{
+		return;
+	}
+
+	AddProjectile(FindOrAddType(ProjectileClass), FireEvent.Origin, FireEvent.GetSpreadDirection(SpreadDegrees), Instigator,
+		bCosmetic ? EProjectileKind::Cosmetic : EProjectileKind::Predicted, FireEvent.Seed, Advance);
+}
+
+void UFPSProjectileSimulationSubsystem::CorrectPredicted(APawn* Instigator, uint16 Seed)
+{
+	for (int32 Index = 0; Index < Positions.Num(); Index++)
+	{
+		if (Kinds[Index] == EProjectileKind::Cosmetic && Seeds[Index] == Seed && Instigators[Index].Get() == Instigator)
+		{
+			RemoveProjectile(Index);
+			return;
+		}
+	}
+}
+
+void UFPSProjectileSimulationSubsystem::AddProjectile(int32 TypeIndex, const FVector& Location, const FVector& Direction, APawn* Instigator,
+	EProjectileKind Kind, uint16 Seed, float Advance)
+{
+	Positions.Add(Location);
+	Velocities.Add(Direction * Types[TypeIndex].Speed);
+	Ages.Add(0.0f);
+	TypeIndices.Add(TypeIndex);
+	Instigators.Add(Instigator);
+	Kinds.Add(Kind);
+	Seeds.Add(Seed);
+	Advances.Add(Advance);
+
+	// Predicted shots are seen by players, the server-only kind isn't drawn
+	const bool bVisible = Kind != EProjectileKind::Authoritative && GetWorld()->GetNetMode() != NM_DedicatedServer;
+	Visuals.Add(bVisible ? AcquireVisual(TypeIndex, Location, Direction.Rotation()) : nullptr);
+}
+
+void UFPSProjectileSimulationSubsystem::RemoveProjectile(int32 Index)
+{
+	ReleaseVisual(Visuals[Index].Get());
+
+	Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Ages.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	TypeIndices.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Instigators.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Kinds.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Seeds.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Advances.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Visuals.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+AFPSProjectile* UFPSProjectileSimulationSubsystem::AcquireVisual(int32 TypeIndex, const FVector& Location, const FRotator& Rotation)
+{
+	const TSubclassOf<AFPSProjectile> ProjectileClass = Types[TypeIndex].ProjectileClass;
+	for (int32 Index = FreeVisuals.Num() - 1; Index >= 0; Index--)
+	{
+		AFPSProjectile* Visual = FreeVisuals[Index].Get();
+		if (Visual && Visual->GetClass() == ProjectileClass)
+		{
+			FreeVisuals.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			Visual->SetActorLocationAndRotation(Location, Rotation);
+			Visual->SetActorHiddenInGame(false);
+			return Visual;
+		}
+	}
+
+	// Only drawn: no replication, collision, movement or lifespan of its own
+	const FTransform SpawnTransform(Rotation, Location);
+	AFPSProjectile* Visual = GetWorld()->SpawnActorDeferred<AFPSProjectile>(ProjectileClass, SpawnTransform, nullptr, nullptr,
+		ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (Visual == nullptr)
+	{
+		return nullptr;
+	}
+
+	Visual->SetReplicates(false);
+	Visual->SetActorEnableCollision(false);
+	Visual->GetProjectileMovement()->SetAutoActivate(false);
+	Visual->FinishSpawning(SpawnTransform);
+	Visual->SetLifeSpan(0.0f);
+	return Visual;
+}
+
+void UFPSProjectileSimulationSubsystem::ReleaseVisual(AFPSProjectile* Visual)
+{
+	if (Visual == nullptr)
+	{
+		return;
+	}
+
+	FreeVisuals.RemoveAllSwap([](const TWeakObjectPtr<AFPSProjectile>& FreeVisual) { return !FreeVisual.IsValid(); });
+	if (FreeVisuals.Num() >= MaxFreeVisuals)
+	{
+		Visual->Destroy();
+		return;
+	}
+
+	Visual->SetActorHiddenInGame(true);
+	FreeVisuals.Add(Visual);
+}
+
+void UFPSProjectileSimulationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const int32 ProjectileNum = Positions.Num();
+	if (ProjectileNum == 0)
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	const float GravityZ = World->GetGravityZ();
+
+	// Integrate, including any catch-up for shots fired in the past
+	SweepEnds.SetNumUninitialized(ProjectileNum);
+	for (int32 Index = 0; Index < ProjectileNum; Index++)
+	{
+		const float StepTime = DeltaTime + Advances[Index];
+		Advances[Index] = 0.0f;
+
+		const FVector Acceleration(0.0f, 0.0f, GravityZ * Types[TypeIndices[Index]].GravityScale);
+		SweepEnds[Index] = Positions[Index] + Velocities[Index] * StepTime + 0.5f * Acceleration * StepTime * StepTime;
+		Velocities[Index] += Acceleration * StepTime;
+		Ages[Index] += StepTime;
+	}
+
+	// Sweep
+	Hits.SetNum(ProjectileNum);
+	bHit.SetNumUninitialized(ProjectileNum);
+	FPSSceneQueries::ParallelQuery(ProjectileNum, [this, World](int32 Index)
+	{
+		const FFPSProjectileTraits& Type = Types[TypeIndices[Index]];
+
+		// Cosmetic copies sweep like the server's but only against world static geometry. Hits on anything else come
+		// from the server as corrections
+		const FCollisionResponseParams& ResponseParams = Kinds[Index] == EProjectileKind::Cosmetic ? CosmeticResponseParams[TypeIndices[Index]] : Type.ResponseParams;
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FPSProjectileSim), false, Instigators[Index].Get());
+		bHit[Index] = World->SweepSingleByChannel(Hits[Index], Positions[Index], SweepEnds[Index], FQuat::Identity,
+			Type.ObjectType, FCollisionShape::MakeSphere(Type.Radius), QueryParams, ResponseParams);
+	});
+
+	// Resolve on the game thread, back to front so removals don't disturb unvisited entries
+	for (int32 Index = ProjectileNum - 1; Index >= 0; Index--)
+	{
+		if (bHit[Index] && Kinds[Index] == EProjectileKind::Cosmetic)
+		{
+			// World static geometry, which the server's copy hits in the same place. The visual is hidden right away,
+			// it was last drawn at the end of the previous step
+			RemoveProjectile(Index);
+			continue;
+		}
+
+		if (bHit[Index])
+		{
+			// Same as AFPSProjectile::OnHit on the server: impact effects, then the projectile is gone
+			const FHitResult& Hit = Hits[Index];
+			AFPSProjectile::ApplyImpact(AFPSProjectile::GetImpactNoiseMaker(World, Hit), Instigators[Index].Get(), Hit, Velocities[Index], true);
+
+			// Clients' copies only stop on world static geometry themselves
+			const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+			AFPSCharacter* Shooter = Cast<AFPSCharacter>(Instigators[Index].Get());
+			if (Kinds[Index] == EProjectileKind::Predicted && Shooter && (HitComponent == nullptr || HitComponent->GetCollisionObjectType() != ECC_WorldStatic))
+			{
+				Shooter->MulticastPredictedImpact(Seeds[Index]);
+			}
+
+			RemoveProjectile(Index);
+			continue;
+		}
+
+		if (Types[TypeIndices[Index]].LifeSpan > 0.0f && Ages[Index] >= Types[TypeIndices[Index]].LifeSpan)
+		{
+			RemoveProjectile(Index);
+			continue;
+		}
+
+		Positions[Index] = SweepEnds[Index];
+
+		if (AFPSProjectile* Visual = Visuals[Index].Get())
+		{
+			Visual->SetActorLocationAndRotation(Positions[Index], Velocities[Index].Rotation());
+		}
+
+		if (GFPSProjectileSimDebug)
+		{
+			DrawDebugSphere(World, Positions[Index], Types[TypeIndices[Index]].Radius, 8, FColor::Orange);
+		}
+	}
+}
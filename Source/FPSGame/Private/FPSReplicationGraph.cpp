@@ -0,0 +1,214 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSReplicationGraph.h"
+#include "FPSCharacter.h"
+#include "FPSAIGuard.h"
+#include "FPSProjectile.h"
+#include "FPSObjectiveActor.h"
+#include "FPSExtractionZone.h"
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Misc/CommandLine.h"
+#include "UObject/UObjectIterator.h"
+
+namespace FPSReplicationGraph
+{
+	static UReplicationDriver* CreateReplicationDriver(UNetDriver* ForNetDriver, const FURL& URL, UWorld* World)
+	{
+		// Only for gameplay traffic, not demo recording or beacons
+		if (World == nullptr || ForNetDriver == nullptr || ForNetDriver->NetDriverName != NAME_GameNetDriver)
+		{
+			return nullptr;
+		}
+
+		if (FParse::Param(FCommandLine::Get(), TEXT("FPSNoRepGraph")))
+		{
+			UE_LOG(LogTemp, Log, TEXT("Replication graph disabled by -FPSNoRepGraph"));
+			return nullptr;
+		}
+
+		return NewObject<UFPSReplicationGraph>(GetTransientPackage());
+	}
+}
+
+UFPSReplicationGraph::UFPSReplicationGraph()
+{
+	// Bound by the default object when the module loads, so no ReplicationDriverClassName is needed in the ini
+	if (!UReplicationDriver::CreateReplicationDriverDelegate().IsBound())
+	{
+		UReplicationDriver::CreateReplicationDriverDelegate().BindStatic(&FPSReplicationGraph::CreateReplicationDriver);
+	}
+}
+
+EFPSClassRepNodeMapping UFPSReplicationGraph::GetDefaultMappingPolicy(const AActor* ActorCDO) const
+{
+	if (ActorCDO->bAlwaysRelevant && !ActorCDO->bOnlyRelevantToOwner)
+	{
+		return EFPSClassRepNodeMapping::RelevantAllConnections;
+	}
+
+	// Reaches its owner through the per-connection node, as the owning connection's view target
+	if (ActorCDO->bOnlyRelevantToOwner)
+	{
+		return EFPSClassRepNodeMapping::NotRouted;
+	}
+
+	if (ActorCDO->IsReplicatingMovement())
+	{
+		return EFPSClassRepNodeMapping::Spatialize_Dynamic;
+	}
+
+	return ActorCDO->NetDormancy > DORM_Awake ? EFPSClassRepNodeMapping::Spatialize_Dormancy : EFPSClassRepNodeMapping::Spatialize_Static;
+}
+
+EFPSClassRepNodeMapping UFPSReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	if (const EFPSClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class))
+	{
+		return *Policy;
+	}
+
+	const EFPSClassRepNodeMapping Policy = GetDefaultMappingPolicy(CastChecked<AActor>(Class->GetDefaultObject()));
+	ClassRepNodePolicies.Set(Class, Policy);
+	return Policy;
+}
+
+void UFPSReplicationGraph::InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, float CullDistance, float NetUpdateFrequency) const
+{
+	const AActor* ActorCDO = CastChecked<AActor>(Class->GetDefaultObject());
+	Info.SetCullDistanceSquared(CullDistance > 0.0f ? FMath::Square(CullDistance) : ActorCDO->GetNetCullDistanceSquared());
+	Info.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(NetUpdateFrequency > 0.0f ? NetUpdateFrequency : ActorCDO->GetNetUpdateFrequency());
+}
+
+void UFPSReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// Subclasses, including Blueprints, use their closest parent's policy
+	ClassRepNodePolicies.Set(AGameStateBase::StaticClass(), EFPSClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EFPSClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(APlayerController::StaticClass(), EFPSClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EFPSClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AReplicationGraphDebugActor::StaticClass(), EFPSClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AFPSCharacter::StaticClass(), EFPSClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AFPSAIGuard::StaticClass(), EFPSClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AFPSProjectile::StaticClass(), EFPSClassRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(AFPSObjectiveActor::StaticClass(), EFPSClassRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(AFPSExtractionZone::StaticClass(), EFPSClassRepNodeMapping::Spatialize_Dormancy);
+
+	// Fallback for classes whose native parents don't replicate
+	FClassReplicationInfo DefaultInfo;
+	InitClassReplicationInfo(DefaultInfo, AActor::StaticClass(), 0.0f, 0.0f);
+	GlobalActorReplicationInfoMap.SetClassInfo(AActor::StaticClass(), DefaultInfo);
+
+	// Every replicated native class. Blueprint classes loaded later use their native parent's settings
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+		if (ActorCDO == nullptr || !ActorCDO->GetIsReplicated())
+		{
+			continue;
+		}
+
+		// Editor-only compilation artifacts
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		float CullDistance = 0.0f;
+		float NetUpdateFrequency = 0.0f;
+		if (Class->IsChildOf(AFPSCharacter::StaticClass()))
+		{
+			CullDistance = CharacterCullDistance;
+		}
+		else if (Class->IsChildOf(AFPSAIGuard::StaticClass()))
+		{
+			CullDistance = GuardCullDistance;
+			NetUpdateFrequency = GuardNetUpdateFrequency;
+		}
+		else if (Class->IsChildOf(AFPSProjectile::StaticClass()))
+		{
+			CullDistance = ProjectileCullDistance;
+		}
+
+		FClassReplicationInfo ClassInfo;
+		InitClassReplicationInfo(ClassInfo, Class, CullDistance, NetUpdateFrequency);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void UFPSReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = GridSpatialBias;
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UFPSReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// The connection's own player controller and view target
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* ConnectionNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(ConnectionNode, RepGraphConnection);
+}
+
+void UFPSReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EFPSClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+
+	case EFPSClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+
+	case EFPSClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+
+	case EFPSClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void UFPSReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EFPSClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+
+	case EFPSClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+
+	case EFPSClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+
+	case EFPSClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+
+	default:
+		break;
+	}
+}
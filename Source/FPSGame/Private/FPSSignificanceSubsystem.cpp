@@ -0,0 +1,218 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FPSSignificanceSubsystem.h"
+#include "GameFramework/MovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Perception/PawnSensingComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommandWithWorld SignificanceStatsCommand(
+	TEXT("FPS.Significance.Stats"),
+	TEXT("Logs the actors per significance tier and the estimated tick time saved"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (const UFPSSignificanceSubsystem* Significance = World ? World->GetSubsystem<UFPSSignificanceSubsystem>() : nullptr)
+		{
+			Significance->LogStats();
+		}
+	}));
+
+static FFPSSignificanceTier MakeSignificanceTier(float MaxDistance, float TickInterval, float MovementTickInterval, float SensingInterval)
+{
+	FFPSSignificanceTier Tier;
+	Tier.MaxDistance = MaxDistance;
+	Tier.TickInterval = TickInterval;
+	Tier.MovementTickInterval = MovementTickInterval;
+	Tier.SensingInterval = SensingInterval;
+	return Tier;
+}
+
+UFPSSignificanceSubsystem::UFPSSignificanceSubsystem()
+{
+	// Overridden by Tiers in DefaultGame.ini
+	Tiers.Add(MakeSignificanceTier(2000.0f, 0.0f, 0.0f, 0.0f));
+	Tiers.Add(MakeSignificanceTier(6000.0f, 0.1f, 0.05f, 1.0f));
+	Tiers.Add(MakeSignificanceTier(MAX_flt, 0.5f, 0.25f, 2.0f));
+}
+
+bool UFPSSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFPSSignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UFPSSignificanceSubsystem::RegisterActor(AActor* Actor)
+{
+	if (Actor == nullptr)
+	{
+		return;
+	}
+
+	FManagedActor& Managed = ManagedActors.AddDefaulted_GetRef();
+	Managed.Actor = Actor;
+	Managed.BaseTickInterval = Actor->GetActorTickInterval();
+
+	TInlineComponentArray<UMovementComponent*> MovementComponents(Actor);
+	Managed.MovementComponentNum = MovementComponents.Num();
+	Managed.BaseMovementTickInterval = MovementComponents.Num() > 0 ? MovementComponents[0]->GetComponentTickInterval() : 0.0f;
+
+	const UPawnSensingComponent* Sensing = Actor->FindComponentByClass<UPawnSensingComponent>();
+	Managed.BaseSensingInterval = Sensing ? Sensing->SensingInterval : 0.0f;
+
+	// Start at full rate until the next update scores it
+	Managed.TickInterval = Managed.BaseTickInterval;
+	Managed.MovementTickInterval = Managed.BaseMovementTickInterval;
+}
+
+void UFPSSignificanceSubsystem::UnregisterActor(AActor* Actor)
+{
+	const int32 Index = ManagedActors.IndexOfByPredicate([Actor](const FManagedActor& Managed) { return Managed.Actor.Get() == Actor; });
+	if (Index != INDEX_NONE)
+	{
+		ApplyTier(ManagedActors[Index], 0);
+		ManagedActors.RemoveAtSwap(Index);
+	}
+}
+
+void UFPSSignificanceSubsystem::RegisterViewer(AActor* Viewer)
+{
+	if (Viewer)
+	{
+		Viewers.AddUnique(Viewer);
+	}
+}
+
+void UFPSSignificanceSubsystem::UnregisterViewer(AActor* Viewer)
+{
+	Viewers.RemoveSingleSwap(Viewer);
+}
+
+void UFPSSignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (ManagedActors.Num() == 0 || DeltaTime <= 0.0f)
+	{
+		return;
+	}
+
+	UpdateTimer += DeltaTime;
+	if (UpdateTimer >= UpdateInterval)
+	{
+		UpdateTimer = 0.0f;
+		UpdateTiers();
+	}
+
+	// An interval of I skips a fraction 1 - DeltaTime / I of the frames
+	for (const FManagedActor& Managed : ManagedActors)
+	{
+		if (Managed.TickInterval > DeltaTime && Managed.Actor.IsValid() && Managed.Actor->IsActorTickEnabled())
+		{
+			SkippedActorTicks += 1.0 - DeltaTime / Managed.TickInterval;
+		}
+		if (Managed.MovementTickInterval > DeltaTime)
+		{
+			SkippedMovementTicks += Managed.MovementComponentNum * (1.0 - DeltaTime / Managed.MovementTickInterval);
+		}
+	}
+}
+
+void UFPSSignificanceSubsystem::UpdateTiers()
+{
+	UWorld* World = GetWorld();
+
+	ViewerLocations.Reset();
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewerLocations.Add(ViewLocation);
+		}
+	}
+
+	Viewers.RemoveAll([](const TWeakObjectPtr<AActor>& Viewer) { return !Viewer.IsValid(); });
+	for (const TWeakObjectPtr<AActor>& Viewer : Viewers)
+	{
+		ViewerLocations.Add(Viewer->GetActorLocation());
+	}
+
+	ManagedActors.RemoveAllSwap([](const FManagedActor& Managed) { return !Managed.Actor.IsValid(); });
+	for (FManagedActor& Managed : ManagedActors)
+	{
+		const FVector Location = Managed.Actor->GetActorLocation();
+		float NearestDistanceSq = MAX_flt;
+		for (const FVector& ViewerLocation : ViewerLocations)
+		{
+			NearestDistanceSq = FMath::Min(NearestDistanceSq, (float)FVector::DistSquared(Location, ViewerLocation));
+		}
+
+		int32 Tier = 0;
+		while (Tier < Tiers.Num() - 1 && NearestDistanceSq > FMath::Square(Tiers[Tier].MaxDistance))
+		{
+			Tier++;
+		}
+
+		if (Tier != Managed.Tier)
+		{
+			ApplyTier(Managed, Tier);
+		}
+	}
+}
+
+void UFPSSignificanceSubsystem::ApplyTier(FManagedActor& Managed, int32 Tier)
+{
+	AActor* Actor = Managed.Actor.Get();
+	if (Actor == nullptr || !Tiers.IsValidIndex(Tier))
+	{
+		return;
+	}
+
+	const FFPSSignificanceTier& Settings = Tiers[Tier];
+	Managed.Tier = Tier;
+	Managed.TickInterval = FMath::Max(Managed.BaseTickInterval, Settings.TickInterval);
+	Managed.MovementTickInterval = FMath::Max(Managed.BaseMovementTickInterval, Settings.MovementTickInterval);
+
+	Actor->SetActorTickInterval(Managed.TickInterval);
+
+	TInlineComponentArray<UMovementComponent*> MovementComponents(Actor);
+	for (UMovementComponent* MovementComponent : MovementComponents)
+	{
+		MovementComponent->SetComponentTickInterval(Managed.MovementTickInterval);
+	}
+
+	if (UPawnSensingComponent* Sensing = Actor->FindComponentByClass<UPawnSensingComponent>())
+	{
+		Sensing->SetSensingInterval(FMath::Max(Managed.BaseSensingInterval, Settings.SensingInterval));
+	}
+}
+
+void UFPSSignificanceSubsystem::LogStats() const
+{
+	TArray<int32> TierCounts;
+	TierCounts.SetNumZeroed(Tiers.Num());
+	for (const FManagedActor& Managed : ManagedActors)
+	{
+		if (TierCounts.IsValidIndex(Managed.Tier))
+		{
+			TierCounts[Managed.Tier]++;
+		}
+	}
+
+	FString TierList;
+	for (int32 Tier = 0; Tier < TierCounts.Num(); Tier++)
+	{
+		TierList += FString::Printf(TEXT("%s%d"), Tier > 0 ? TEXT("/") : TEXT(""), TierCounts[Tier]);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Significance: %d actors (per tier %s), %d viewers, %.0f ticks skipped, ~%.1f ms saved"),
+		ManagedActors.Num(), *TierList, ViewerLocations.Num(), GetSkippedTickNum(), GetEstimatedMsSaved());
+}
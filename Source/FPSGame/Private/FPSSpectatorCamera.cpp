@@ -7,7 +7,8 @@
 
 AFPSSpectatorCamera::AFPSSpectatorCamera()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Moves from input only
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Create root component
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
@@ -36,11 +37,6 @@ void AFPSSpectatorCamera::BeginPlay()
 	SetActorRotation(FRotator(-45, 0, 0));
 }
 
-void AFPSSpectatorCamera::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-}
-
 void AFPSSpectatorCamera::MoveForward(float Value)
 {
 	if (Value != 0.0f)
@@ -4,9 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "AITypes.h"
+#include "Navigation/PathFollowingComponent.h"
 #include "FPSAIGuard.generated.h"
 
 class UPawnSensingComponent;
+class AFPSPatrolRoute;
 
 UENUM(BlueprintType)
 enum class EAIState : uint8
@@ -29,9 +32,15 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UPROPERTY(VisibleAnywhere, Category = "Components")
 	UPawnSensingComponent* PawnSensingComp;
 
+	// Let UFPSGuardPerceptionSubsystem and UFPSNoiseSubsystem sense for this guard instead of the sensing component polling on its own
+	UPROPERTY(EditAnywhere, Category = "AI")
+	bool bUseSharedPerception = true;
+
 	UFUNCTION()
 	void OnPawnSeen(APawn* SeenPawn);
 
@@ -66,10 +75,23 @@ protected:
 
 	AActor* CurrentPatrolPoint;
 
+	// Shared multi-waypoint route, used instead of the two patrol points when set
+	UPROPERTY(EditInstanceOnly, Category = "AI", meta = (EditCondition = "bPatrol"))
+	AFPSPatrolRoute* PatrolRoute;
+
+	// How close counts as arriving at a patrol point
+	UPROPERTY(EditAnywhere, Category = "AI", meta = (EditCondition = "bPatrol"))
+	float PatrolAcceptanceRadius = 50.0f;
+
+	int32 PatrolWaypoint = INDEX_NONE;
+	int32 PatrolDirection = 1;
+
 	void MoveToNextPatrolPoint();
 
+	UFUNCTION()
+	void OnMoveCompleted(FAIRequestID RequestID, EPathFollowingResult::Type Result);
+
 public:
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	UPawnSensingComponent* GetPawnSensingComponent() const { return PawnSensingComp; }
 
 };
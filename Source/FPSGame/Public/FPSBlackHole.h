@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "FPSGravityFieldSubsystem.h"
 #include "FPSBlackHole.generated.h"
 
 class USphereComponent;
@@ -28,14 +29,29 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = "Components")
 	USphereComponent* OuterSphereComp;
 
+	// Acceleration applied to simulating bodies inside the outer sphere, negative pulls them in
+	UPROPERTY(EditAnywhere, Category = "Gravity")
+	float ForceStrength = -2000.0f;
+
+	// InverseSquare keeps full strength inside the inner sphere
+	UPROPERTY(EditAnywhere, Category = "Gravity")
+	EFPSGravityFalloff Falloff = EFPSGravityFalloff::Constant;
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UFUNCTION()
 	void OnOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
-public:
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	UFUNCTION()
+	void OnOuterOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnOuterOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	// Handle of this black hole in the world's gravity field
+	int32 GravitySource = INDEX_NONE;
 
 };
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "FPSProjectileFireEvent.h"
 #include "FPSCharacter.generated.h"
 
 class UInputComponent;
@@ -14,6 +15,21 @@ class USoundBase;
 class UAnimSequence;
 class UPawnNoiseEmitterComponent;
 
+UENUM(BlueprintType)
+enum class EFPSFireMode : uint8
+{
+	// Spawn (or take from the pool) a replicated projectile actor
+	Actor,
+
+	// Simulate the projectile in UFPSProjectileSimulationSubsystem without an actor
+	Simulated,
+
+	// Resolve the shot instantly with a line trace batched in UFPSHitscanSubsystem
+	Hitscan,
+
+	// Simulate the projectile on every machine from a replicated fire event, the server's copy decides hits
+	Predicted
+};
 
 UCLASS()
 class AFPSCharacter : public ACharacter
@@ -44,6 +60,26 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category="Projectile")
 	TSubclassOf<AFPSProjectile> ProjectileClass;
 
+	/** How fired projectiles are simulated */
+	UPROPERTY(EditDefaultsOnly, Category="Projectile")
+	EFPSFireMode FireMode = EFPSFireMode::Actor;
+
+	/** How far hitscan shots reach */
+	UPROPERTY(EditDefaultsOnly, Category="Projectile", meta = (EditCondition = "FireMode == EFPSFireMode::Hitscan"))
+	float HitscanRange = 10000.0f;
+
+	/** Random spread of predicted shots, in degrees from the aim direction */
+	UPROPERTY(EditDefaultsOnly, Category="Projectile", meta = (ClampMin = "0", EditCondition = "FireMode == EFPSFireMode::Predicted"))
+	float FireSpreadDegrees = 0.0f;
+
+	/** Most latency the server makes up for by advancing a predicted shot, in seconds */
+	UPROPERTY(EditDefaultsOnly, Category="Projectile", meta = (ClampMin = "0", EditCondition = "FireMode == EFPSFireMode::Predicted"))
+	float MaxPredictionAge = 0.25f;
+
+	/** Projectiles kept ready in the world's projectile pool on the server */
+	UPROPERTY(EditDefaultsOnly, Category="Projectile", meta = (ClampMin = "0"))
+	int32 ProjectilePoolSize = 32;
+
 	/** Sound to play each time we fire */
 	UPROPERTY(EditDefaultsOnly, Category="Gameplay")
 	USoundBase* FireSound;
@@ -57,12 +93,20 @@ public:
 
 protected:
 
-	/** Fires a projectile. */
-	void Fire();
+	virtual void BeginPlay() override;
 
 	UFUNCTION(Server, Reliable, WithValidation)
 	void ServerFire();
 
+	/** Simulates the shot locally right away and sends it to the server */
+	void FirePredicted();
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerFirePredicted(const FFPSProjectileFireEvent& FireEvent);
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastFirePredicted(const FFPSProjectileFireEvent& FireEvent);
+
 	/** Handles moving forward/backward */
 	void MoveForward(float Val);
 
@@ -72,6 +116,13 @@ protected:
 	virtual void SetupPlayerInputComponent(UInputComponent* InputComponent) override;
 
 public:
+	/** Fires a projectile. */
+	void Fire();
+
+	/** Tells clients the server's copy of a predicted shot hit something other than world static geometry. Reliable, as a lost correction leaves their copy flying on through the target */
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastPredictedImpact(uint16 Seed);
+
 	/** Returns Mesh1P subobject **/
 	USkeletalMeshComponent* GetMesh1P() const { return Mesh1PComponent; }
 
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSGravityFieldSubsystem.generated.h"
+
+class UPrimitiveComponent;
+class USphereComponent;
+
+UENUM(BlueprintType)
+enum class EFPSGravityFalloff : uint8
+{
+	// Full strength everywhere inside the radius
+	Constant,
+
+	// Fades linearly to zero at the radius
+	Linear,
+
+	// Full strength inside the core radius, falling off with the square of the distance outside it
+	InverseSquare
+};
+
+/**
+ * Pulls simulating bodies towards gravity sources such as black holes.
+ * Sources keep their member bodies up to date from overlap events instead of querying overlaps every frame.
+ * Each tick sums the acceleration of all sources on each affected body and applies it with one AddForce per body.
+ */
+UCLASS()
+class FPSGAME_API UFPSGravityFieldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Adds a source centred on Field that reaches as far as its radius. Negative Strength pulls inwards.
+	 * Bodies already overlapping Field become members. Returns a handle for the other calls.
+	 */
+	int32 RegisterSource(USphereComponent* Field, float Strength, EFPSGravityFalloff Falloff, float CoreRadius);
+	void UnregisterSource(int32 Source);
+
+	// Call from the field's begin/end overlap events
+	void AddMember(int32 Source, UPrimitiveComponent* Component);
+	void RemoveMember(int32 Source, UPrimitiveComponent* Component);
+
+	int32 GetSourceNum() const { return Sources.Num(); }
+	int32 GetBodyNum() const { return Bodies.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FGravitySource
+	{
+		TWeakObjectPtr<USphereComponent> Field;
+		float Strength = 0.0f;
+		EFPSGravityFalloff Falloff = EFPSGravityFalloff::Constant;
+		float CoreRadius = 0.0f;
+	};
+
+	struct FGravityBody
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		// Stays valid for removal from BodyIndices after the component is gone
+		TObjectKey<UPrimitiveComponent> Key;
+		// Sources the body is inside
+		TArray<int32, TInlineAllocator<4>> Sources;
+	};
+
+	void RemoveBody(int32 BodyIndex);
+
+	TSparseArray<FGravitySource> Sources;
+
+	TArray<FGravityBody> Bodies;
+	TMap<TObjectKey<UPrimitiveComponent>, int32> BodyIndices;
+
+	// Source origin and radius, gathered once per tick
+	TArray<FVector> SourceOrigins;
+	TArray<float> SourceRadii;
+};
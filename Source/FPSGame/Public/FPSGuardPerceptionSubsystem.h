@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSGuardPerceptionSubsystem.generated.h"
+
+class AFPSAIGuard;
+
+/**
+ * Sight for every guard in the world, replacing each guard's own UPawnSensingComponent polling. Hearing is
+ * handled by UFPSNoiseSubsystem. An update cycle takes one snapshot of the candidate pawns, then works through the
+ * guards a slice at a time: distance and view cone culling four pawns at a time with SIMD, followed by one parallel
+ * batch of line-of-sight traces for the slice. Slices are processed until BudgetMs is spent, and the cycle continues
+ * next frame. The guards' sensing components still hold the settings, and results are broadcast through their
+ * OnSeePawn delegate, so AFPSAIGuard::OnPawnSeen is unchanged.
+ */
+UCLASS(config = Game)
+class FPSGAME_API UFPSGuardPerceptionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Takes over sensing for the guard. Its sensing component stops updating itself
+	void RegisterGuard(AFPSAIGuard* Guard);
+	void UnregisterGuard(AFPSAIGuard* Guard);
+
+	// Milliseconds per frame spent on perception
+	UPROPERTY(config)
+	float BudgetMs = 1.0f;
+
+	// Seconds between the starts of update cycles, like UPawnSensingComponent::SensingInterval
+	UPROPERTY(config)
+	float UpdateInterval = 0.5f;
+
+	// Guards culled and traced together
+	UPROPERTY(config)
+	int32 GuardsPerSlice = 8;
+
+	int32 GetGuardNum() const { return Guards.Num(); }
+
+	// Duration of the last complete cycle, in frames and seconds
+	int32 GetLastCycleFrames() const { return LastCycleFrames; }
+	float GetLastCycleSeconds() const { return LastCycleSeconds; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FGuardEntry
+	{
+		TWeakObjectPtr<AFPSAIGuard> Guard;
+		// Cycle the guard was last sensed in
+		float SenseTime = 0.0f;
+	};
+
+	struct FPendingTrace
+	{
+		int32 GuardIndex = INDEX_NONE;
+		int32 CandidateIndex = INDEX_NONE;
+		FVector Start = FVector::ZeroVector;
+		FVector End = FVector::ZeroVector;
+		const AActor* Guard = nullptr;
+		const AActor* Pawn = nullptr;
+	};
+
+	void BeginCycle();
+	void ProcessSlice(int32 FirstGuard, int32 LastGuard);
+	void CullGuard(int32 GuardIndex);
+
+	TArray<FGuardEntry> Guards;
+
+	// Candidate snapshot for the current cycle, padded to a multiple of four for the SIMD culling
+	TArray<TWeakObjectPtr<APawn>> CandidatePawns;
+	TArray<float> CandidateX;
+	TArray<float> CandidateY;
+	TArray<float> CandidateZ;
+	TArray<uint8> bCandidatePlayer;
+
+	TArray<FPendingTrace> PendingTraces;
+	TArray<uint8> bTraceBlocked;
+
+	bool bCycleActive = false;
+	int32 Cursor = 0;
+	float CycleTime = 0.0f;
+	int32 CycleFrames = 0;
+	int32 LastCycleFrames = 0;
+	float LastCycleSeconds = 0.0f;
+};
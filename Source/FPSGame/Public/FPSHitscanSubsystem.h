@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+#include "FPSProjectile.h"
+#include "FPSHitscanSubsystem.generated.h"
+
+class AFPSProjectile;
+
+/**
+ * Resolves hitscan shots on the server. Shots fired during a frame are queued and traced together in parallel
+ * at the end of the frame, then impacts are applied with AFPSProjectile::ApplyImpact as if the character's
+ * projectile had hit at its initial speed.
+ */
+UCLASS()
+class FPSGAME_API UFPSHitscanSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// ProjectileClass supplies the trace channel and the speed used for the impulse
+	void QueueShot(TSubclassOf<AFPSProjectile> ProjectileClass, const FVector& Start, const FVector& Direction, float Range, APawn* Instigator);
+
+	int32 GetQueuedNum() const { return Shots.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FShot
+	{
+		FVector Start;
+		FVector End;
+		FVector Velocity;
+		ECollisionChannel TraceChannel;
+		TWeakObjectPtr<APawn> Instigator;
+	};
+
+	const FFPSProjectileTraits& FindOrAddType(TSubclassOf<AFPSProjectile> ProjectileClass);
+
+	TArray<FFPSProjectileTraits> Types;
+
+	TArray<FShot> Shots;
+	TArray<int32> ShotTypeIndices;
+	TArray<FHitResult> Hits;
+	TArray<uint8> bHit;
+};
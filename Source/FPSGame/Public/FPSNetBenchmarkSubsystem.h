@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSNetBenchmarkSubsystem.generated.h"
+
+class UNetDriver;
+
+/**
+ * Measures the server's bandwidth and CPU cost with many clients connected, to compare replication settings. Only
+ * created on servers started with -FPSNetBenchmark=<Seconds>. Once -FPSNetBenchmarkClients=<N> clients are connected
+ * and -FPSNetBenchmarkWarmup=<Seconds> (10 by default) have passed, it samples the server's busy time per frame and
+ * the net driver's traffic for the given number of seconds, writes a JSON report to Saved/NetBenchmark (or
+ * -FPSNetBenchmarkOutputDir=<Dir>) and quits. scripts/RunNetBenchmark.bat runs a dedicated server like this with
+ * headless bot clients, see AFPSPlayerController.
+ */
+UCLASS()
+class FPSGAME_API UFPSNetBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	enum class EPhase : uint8
+	{
+		WaitingForClients,
+		Warmup,
+		Sampling,
+		Done
+	};
+
+	void BeginSampling(const UNetDriver* NetDriver);
+	void WriteReport(const UNetDriver* NetDriver);
+
+	float Duration = 0.0f;
+	float WarmupSeconds = 10.0f;
+	int32 ExpectedClientNum = 0;
+
+	EPhase Phase = EPhase::WaitingForClients;
+	double PhaseStartTime = 0.0;
+
+	// Net driver totals when sampling started
+	uint32 StartOutBytes = 0;
+	uint32 StartInBytes = 0;
+	uint32 StartOutPackets = 0;
+
+	// Per sampled frame
+	TArray<float> ServerMs;
+	int32 MinClientNum = 0;
+	int32 MaxClientNum = 0;
+};
@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GameFramework/Actor.h"
+#include "FPSNoiseSubsystem.generated.h"
+
+class UPawnSensingComponent;
+
+/**
+ * Delivers noise to listening pawn sensing components without every listener checking every noise. AActor::MakeNoise
+ * is routed here, and each noise is added to the grid cells its audible radius overlaps: the loudness times the
+ * largest hearing threshold of any listener. Once a frame, each listener only looks at the noises in its own cell,
+ * and hears one of them: the nearest relative to its loudness, preferring noise heard through walls to noise that
+ * needs line of sight. Line of sight for all listeners is traced in one parallel batch. Results are broadcast through
+ * the sensing component's OnHearNoise, so AFPSAIGuard::OnNoiseHeard is unchanged.
+ */
+UCLASS(config = Game)
+class FPSGAME_API UFPSNoiseSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Queues a noise for delivery at the end of the frame. MaxRange limits the audible radius when above zero
+	void ReportNoise(AActor* NoiseMaker, APawn* NoiseInstigator, const FVector& Location, float Loudness, float MaxRange = 0.0f);
+
+	// Takes over hearing for the component. It no longer needs to poll pawn noise emitters
+	void RegisterListener(UPawnSensingComponent* Sensing);
+	void UnregisterListener(UPawnSensingComponent* Sensing);
+
+	void LogStats() const;
+
+	// AActor doesn't expose the delegate it holds, so code that installs its own MakeNoise delegate goes through here.
+	// While a world routes noise, the delegate is chained behind RouteMakeNoise instead of replacing it
+	static void SetMakeNoiseDelegate(const FMakeNoiseDelegate& NewDelegate);
+
+	// Width of the square grid cells, in the horizontal plane
+	UPROPERTY(config)
+	float CellSize = 1000.0f;
+
+	// Noises whose radius overlaps more cells than this are delivered to every listener instead
+	UPROPERTY(config)
+	int32 MaxCellsPerNoise = 64;
+
+	int32 GetListenerNum() const { return Listeners.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FNoiseEvent
+	{
+		FVector Location = FVector::ZeroVector;
+		float Loudness = 0.0f;
+		float MaxRange = 0.0f;
+		TWeakObjectPtr<APawn> Instigator;
+		TWeakObjectPtr<AActor> NoiseMaker;
+	};
+
+	struct FPendingNoise
+	{
+		TWeakObjectPtr<UPawnSensingComponent> Listener;
+		int32 EventIndex = INDEX_NONE;
+		FVector Start = FVector::ZeroVector;
+		const AActor* Owner = nullptr;
+		// Needs line of sight. Noise within the hearing threshold doesn't
+		bool bTrace = false;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const;
+
+	// Adds the event to the listener's pending noise if it is audible and better than the one found so far
+	void ConsiderEvent(const UPawnSensingComponent* Sensing, const FVector& SensorLocation, int32 EventIndex,
+		int32& InOutBest, float& InOutBestScore, bool& bInOutBestThroughWalls) const;
+
+	static void RouteMakeNoise(AActor* NoiseMaker, float Loudness, APawn* NoiseInstigator, const FVector& NoiseLocation, float MaxRange, FName Tag);
+
+	TArray<TWeakObjectPtr<UPawnSensingComponent>> Listeners;
+
+	// Largest of the listeners' hearing thresholds, which sets the radius a noise is bucketed with
+	float MaxHearingRange = 0.0f;
+
+	// Reported this frame, and being delivered. Swapped at the start of Tick so handlers can report new noise
+	TArray<FNoiseEvent> Events;
+	TMap<FIntPoint, TArray<int32>> Cells;
+	TArray<int32> UnbucketedEvents;
+	TArray<FNoiseEvent> DeliveryEvents;
+	TMap<FIntPoint, TArray<int32>> DeliveryCells;
+	TArray<int32> DeliveryUnbucketedEvents;
+
+	TArray<FPendingNoise> PendingNoises;
+	TArray<uint8> bTraceBlocked;
+
+	// Totals for the stats command
+	int64 EventNum = 0;
+	int64 CandidateChecks = 0;
+	int64 DeliveredNum = 0;
+
+	// Worlds with a noise subsystem, while AActor::MakeNoise is routed through RouteMakeNoise
+	static int32 RoutedWorldNum;
+
+	// The delegate that was installed before routing, called by RouteMakeNoise and restored once no world routes noise
+	static FMakeNoiseDelegate ChainedMakeNoise;
+};
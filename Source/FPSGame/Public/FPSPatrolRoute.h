@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "FPSPatrolRoute.generated.h"
+
+class USplineComponent;
+
+// Patrol waypoints shared by any number of guards. Each spline point is a waypoint
+UCLASS()
+class FPSGAME_API AFPSPatrolRoute : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	AFPSPatrolRoute();
+
+	int32 GetWaypointNum() const { return Waypoints.Num(); }
+
+	FVector GetWaypoint(int32 Index) const { return Waypoints[Index]; }
+
+	int32 FindNearestWaypoint(const FVector& Location) const;
+
+	// Waypoint after Current, walking in InOutDirection (1 or -1). Starts at the waypoint nearest Location
+	int32 GetNextWaypoint(int32 Current, int32& InOutDirection, const FVector& Location) const;
+
+protected:
+
+	UPROPERTY(VisibleAnywhere, Category = "Components")
+	USplineComponent* SplineComp;
+
+	// Go from the last waypoint back to the first, otherwise turn around at either end
+	UPROPERTY(EditAnywhere, Category = "Patrol")
+	bool bLoop = true;
+
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	// Construction scripts don't run again for cooked or PIE-duplicated actors, so the cache is also built here
+	virtual void PostInitializeComponents() override;
+
+	void CacheWaypoints();
+
+	// World space waypoints, cached because the route doesn't move
+	TArray<FVector> Waypoints;
+
+};
@@ -25,9 +25,37 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void PlayerTick(float DeltaTime) override;
+
 	// Called to bind functionality to input
 	virtual void SetupInputComponent() override;
 
+	// Headless benchmark client (-FPSBotClient): walks, turns and fires on its own, and quits when the server goes away
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bot")
+	bool bBotClient = false;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float BotFireInterval = 0.5f;
+
+	// Seconds between picking a new turn rate, randomized by half either way
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float BotTurnInterval = 2.0f;
+
+	// Degrees per second at full turn rate
+	UPROPERTY(EditDefaultsOnly, Category = "Bot")
+	float BotMaxTurnRate = 90.0f;
+
+	void UpdateBot(float DeltaTime);
+
+	void OnBotNetworkFailure(UWorld* World, UNetDriver* NetDriver, ENetworkFailure::Type FailureType, const FString& ErrorString);
+
+	float BotFireTimer = 0.0f;
+	float BotTurnTimer = 0.0f;
+	float BotTurnRate = 0.0f;
+	FDelegateHandle BotNetworkFailureHandle;
+
 	// Spectator mode variables
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Spectator")
 	bool bIsSpectating = false;
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "CollisionQueryParams.h"
 #include "FPSProjectile.generated.h"
 
 
@@ -34,10 +35,63 @@ public:
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
+	/**
+	 * Side effects of a projectile impact shared by every fire mode: pushes simulating bodies and, on the server,
+	 * makes noise at the impact for guards to hear. NoiseMaker must not be a pawn, or the noise is heard at the pawn.
+	 */
+	static void ApplyImpact(AActor* NoiseMaker, APawn* NoiseInstigator, const FHitResult& Hit, const FVector& Velocity, bool bAuthority);
+
+	/** NoiseMaker for ApplyImpact when there is no projectile actor: the hit actor, or the world settings for pawns */
+	static AActor* GetImpactNoiseMaker(UWorld* World, const FHitResult& Hit);
+
 	/** Returns CollisionComp subobject **/
 	USphereComponent* GetCollisionComp() const { return CollisionComp; }
 
 	/** Returns ProjectileMovement subobject **/
 	UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovement; }
+
+	/** Puts a pooled projectile back into flight from Location along Rotation */
+	void ActivateFromPool(const FVector& Location, const FRotator& Rotation, APawn* InInstigator);
+
+	/** Hides the projectile and stops its movement and collision until it is fired again */
+	void DeactivateForPool();
+
+	bool IsActiveInPool() const { return bPooled && !bParked; }
+
+	/** Owned by UFPSProjectilePoolSubsystem, returned to the pool instead of destroyed */
+	bool bPooled = false;
+
+protected:
+
+	virtual void LifeSpanExpired() override;
+
+	/** Returns pooled projectiles to their pool and destroys the rest */
+	void Expire();
+
+	/** Parked in the pool. Replicated, as collision and movement state are not */
+	UPROPERTY(ReplicatedUsing = OnRep_Parked)
+	bool bParked = false;
+
+	UFUNCTION()
+	void OnRep_Parked();
+
+	/** Shows and launches the projectile along its rotation, or hides and stops it while parked */
+	void ApplyParked();
 };
 
+/**
+ * What the actorless fire modes need to know about a projectile class, read once from its class default object so
+ * the same projectile Blueprint works in every fire mode.
+ */
+struct FFPSProjectileTraits
+{
+	TSubclassOf<AFPSProjectile> ProjectileClass;
+	float Radius = 0.0f;
+	float Speed = 0.0f;
+	float GravityScale = 1.0f;
+	float LifeSpan = 0.0f;
+	ECollisionChannel ObjectType = ECC_WorldDynamic;
+	FCollisionResponseParams ResponseParams;
+
+	static FFPSProjectileTraits FromClass(TSubclassOf<AFPSProjectile> ProjectileClass);
+};
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FPSProjectileFireEvent.generated.h"
+
+/**
+ * One predicted shot, as sent between machines instead of a replicated projectile actor (see EFPSFireMode::Predicted).
+ * Every machine simulates the projectile from this. The seed picks the spread and identifies the shot among its
+ * instigator's shots in flight. Serialized to under 20 bytes.
+ */
+USTRUCT()
+struct FPSGAME_API FFPSProjectileFireEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector Origin = FVector::ZeroVector;
+
+	// Unit direction before spread
+	UPROPERTY()
+	FVector Direction = FVector::ForwardVector;
+
+	// Server world time the shot was fired at, as estimated by the firing client
+	UPROPERTY()
+	float Time = 0.0f;
+
+	UPROPERTY()
+	uint16 Seed = 0;
+
+	// Direction after the seed's spread within SpreadDegrees of Direction, the same on every machine
+	FVector GetSpreadDirection(float SpreadDegrees) const;
+
+	// Rounds to what NetSerialize sends, so the firing machine simulates the same shot as everyone else
+	void Quantize();
+
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+private:
+	static void CompressDirection(const FVector& InDirection, uint16& OutYaw, uint16& OutPitch);
+	static FVector DecompressDirection(uint16 Yaw, uint16 Pitch);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFPSProjectileFireEvent> : public TStructOpsTypeTraitsBase2<FFPSProjectileFireEvent>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSProjectilePoolSubsystem.generated.h"
+
+class AFPSProjectile;
+
+USTRUCT()
+struct FFPSProjectilePool
+{
+	GENERATED_BODY()
+
+	// Inactive projectiles ready to be fired
+	UPROPERTY()
+	TArray<AFPSProjectile*> Pooled;
+
+	int32 ActiveNum = 0;
+	int32 PeakActiveNum = 0;
+	int32 AcquireNum = 0;
+	// Acquires that found the pool empty and had to spawn
+	int32 MissNum = 0;
+	// Released projectiles destroyed because the pool was full
+	int32 OverflowNum = 0;
+};
+
+/**
+ * Server-side pool of projectiles per projectile class, so firing doesn't construct and destroy actors.
+ * Pooled projectiles stay in the world hidden, without collision and with their movement deactivated.
+ */
+UCLASS()
+class FPSGAME_API UFPSProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Makes sure at least Count projectiles of ProjectileClass exist, pooled or in flight
+	void Prewarm(TSubclassOf<AFPSProjectile> ProjectileClass, int32 Count);
+
+	// Fires a projectile from the pool, spawning one if the pool is empty
+	AFPSProjectile* Acquire(TSubclassOf<AFPSProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* Instigator);
+
+	// Called when a projectile hits something or its lifespan runs out
+	void Release(AFPSProjectile* Projectile);
+
+	const FFPSProjectilePool* FindPool(TSubclassOf<AFPSProjectile> ProjectileClass) const { return Pools.Find(ProjectileClass); }
+
+	void LogStats() const;
+
+	// Projectiles beyond this many pooled per class are destroyed on release
+	int32 MaxPooledPerClass = 256;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	AFPSProjectile* SpawnPooled(TSubclassOf<AFPSProjectile> ProjectileClass);
+
+	UPROPERTY()
+	TMap<TSubclassOf<AFPSProjectile>, FFPSProjectilePool> Pools;
+};
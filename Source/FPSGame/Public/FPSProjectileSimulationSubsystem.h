@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+#include "FPSProjectile.h"
+#include "FPSProjectileSimulationSubsystem.generated.h"
+
+class AFPSProjectile;
+struct FFPSProjectileFireEvent;
+
+/**
+ * Simulates projectiles without actors. In-flight projectiles are kept as parallel arrays and advanced in one
+ * pass per frame: integrate, sweep every projectile in parallel, then apply impacts on the game thread with
+ * AFPSProjectile::ApplyImpact. Projectile radius, collision, gravity scale and lifespan come from the class default
+ * object, so the same projectile Blueprint works in either fire mode.
+ *
+ * Predicted shots (EFPSFireMode::Predicted) are simulated on every machine from the same fire event. The server's
+ * copy is the real one. Copies on clients are cosmetic: they are drawn with a local, non-replicated projectile actor
+ * and only collide with world static geometry, which every machine agrees on. Where the server's copy hits anything
+ * else, the clients are sent a correction that stops their copy there.
+ */
+UCLASS()
+class FPSGAME_API UFPSProjectileSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void Fire(TSubclassOf<AFPSProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, APawn* Instigator);
+
+	/** Adds a predicted shot, advanced by Advance seconds on the next tick to catch up with when it was fired */
+	void FirePredicted(TSubclassOf<AFPSProjectile> ProjectileClass, const FFPSProjectileFireEvent& FireEvent, APawn* Instigator,
+		float SpreadDegrees, float Advance, bool bCosmetic);
+
+	/** Removes the cosmetic copy of Instigator's shot with this seed, as the server's copy hit something other than world static geometry */
+	void CorrectPredicted(APawn* Instigator, uint16 Seed);
+
+	int32 GetInFlightNum() const { return Positions.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	enum class EProjectileKind : uint8
+	{
+		// Server only, nobody else simulates it
+		Authoritative,
+
+		// The server's copy of a predicted shot, which sends corrections
+		Predicted,
+
+		// A client's copy of a predicted shot
+		Cosmetic
+	};
+
+	int32 FindOrAddType(TSubclassOf<AFPSProjectile> ProjectileClass);
+
+	void AddProjectile(int32 TypeIndex, const FVector& Location, const FVector& Direction, APawn* Instigator,
+		EProjectileKind Kind, uint16 Seed, float Advance);
+
+	void RemoveProjectile(int32 Index);
+
+	// Visuals are kept hidden for reuse instead of destroyed, up to MaxFreeVisuals
+	AFPSProjectile* AcquireVisual(int32 TypeIndex, const FVector& Location, const FRotator& Rotation);
+	void ReleaseVisual(AFPSProjectile* Visual);
+
+	static const int32 MaxFreeVisuals = 64;
+
+	TArray<FFPSProjectileTraits> Types;
+	// Per type, the server's response params with everything but world static geometry ignored
+	TArray<FCollisionResponseParams> CosmeticResponseParams;
+
+	// One entry per projectile in flight
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> Ages;
+	TArray<int32> TypeIndices;
+	TArray<TWeakObjectPtr<APawn>> Instigators;
+	TArray<EProjectileKind> Kinds;
+	TArray<uint16> Seeds;
+	// Extra time to simulate on the next tick, for shots that were fired in the past
+	TArray<float> Advances;
+	// Local actor drawing the projectile, null where nobody can see it (like on a dedicated server)
+	TArray<TWeakObjectPtr<AFPSProjectile>> Visuals;
+
+	TArray<TWeakObjectPtr<AFPSProjectile>> FreeVisuals;
+
+	// Per-frame sweep results
+	TArray<FVector> SweepEnds;
+	TArray<FHitResult> Hits;
+	TArray<uint8> bHit;
+};
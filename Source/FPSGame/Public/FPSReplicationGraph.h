@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "FPSReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+
+// Which node a replicated class is added to
+enum class EFPSClassRepNodeMapping : uint32
+{
+	// Not replicated through the graph's global nodes, like player controllers (see the per-connection node)
+	NotRouted,
+
+	// Relevant to every connection, like the game state
+	RelevantAllConnections,
+
+	// Placed in the grid once and never moved
+	Spatialize_Static,
+
+	// Moved between grid cells as it moves, like characters and guards
+	Spatialize_Dynamic,
+
+	// Static while dormant and dynamic while awake, like the objective and pooled projectiles
+	Spatialize_Dormancy,
+};
+
+/**
+ * Replication graph for large matches. Characters, guards and projectiles are bucketed into a 2D spatial grid so each
+ * connection only considers the actors in the cells around its viewer, the game state and player states are always
+ * relevant, and each connection's own player controller and view target come from a per-connection node. Actors that
+ * rarely change are dormant and cost nothing until they wake up.
+ *
+ * Created for the game net driver unless the server is started with -FPSNoRepGraph, which is useful for comparing
+ * against the default replication with the net benchmark (see UFPSNetBenchmarkSubsystem).
+ */
+UCLASS(transient, config = Engine)
+class FPSGAME_API UFPSReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	UFPSReplicationGraph();
+
+	virtual void InitGlobalActorClassSettings() override;
+	virtual void InitGlobalGraphNodes() override;
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	// Grid cell size, and the offset that keeps the level's negative coordinates inside the grid
+	UPROPERTY(config)
+	float GridCellSize = 10000.0f;
+
+	UPROPERTY(config)
+	FVector2D GridSpatialBias = FVector2D(-200000.0f, -200000.0f);
+
+	// Spatialized actors further than these from a connection's viewer aren't replicated to it
+	UPROPERTY(config)
+	float CharacterCullDistance = 15000.0f;
+
+	UPROPERTY(config)
+	float GuardCullDistance = 12000.0f;
+
+	UPROPERTY(config)
+	float ProjectileCullDistance = 8000.0f;
+
+	// Guards only change state occasionally and move slowly, so they can replicate less often than players
+	UPROPERTY(config)
+	float GuardNetUpdateFrequency = 20.0f;
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+private:
+	// Explicit policy of the class or its closest parent with one, otherwise the default policy (cached)
+	EFPSClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	// Policy for a class without an explicit one, from its default object's replication settings
+	EFPSClassRepNodeMapping GetDefaultMappingPolicy(const AActor* ActorCDO) const;
+
+	// Cull distance and replication period from the default object, unless overridden with values above zero
+	void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, float CullDistance, float NetUpdateFrequency) const;
+
+	TClassMap<EFPSClassRepNodeMapping> ClassRepNodePolicies;
+};
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/ParallelFor.h"
+
+namespace FPSSceneQueries
+{
+	/** Below this many items a batch stays on the calling thread, where waking workers would cost more */
+	constexpr int32 MinParallelBatchNum = 16;
+
+	/** Runs Body for every index of a batch of independent work, on task graph workers once the batch is big enough */
+	template <typename BodyType>
+	void ParallelBatch(int32 Num, BodyType&& Body)
+	{
+		ParallelFor(Num, Forward<BodyType>(Body), Num < MinParallelBatchNum ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+	}
+
+	/**
+	 * Runs Query for every index of a batch of independent traces or sweeps. Scene queries only read the physics
+	 * scene, so they can run on task graph workers as long as Query writes nothing but its own index's result.
+	 * Anything that touches game state with the results belongs on the game thread afterwards.
+	 */
+	template <typename QueryType>
+	void ParallelQuery(int32 Num, QueryType&& Query)
+	{
+		ParallelBatch(Num, Forward<QueryType>(Query));
+	}
+}
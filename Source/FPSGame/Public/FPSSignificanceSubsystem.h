@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSSignificanceSubsystem.generated.h"
+
+// Update rates for actors up to MaxDistance from the nearest viewer. Zero keeps the actor's own setting
+USTRUCT()
+struct FFPSSignificanceTier
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	float MaxDistance = 0.0f;
+
+	UPROPERTY()
+	float TickInterval = 0.0f;
+
+	UPROPERTY()
+	float MovementTickInterval = 0.0f;
+
+	UPROPERTY()
+	float SensingInterval = 0.0f;
+};
+
+/**
+ * Lowers the update rate of registered actors that are far from every viewer. Viewers are the players' view points
+ * plus registered actors such as learning agents. Every UpdateInterval each actor is put in the first tier whose
+ * MaxDistance covers its nearest viewer, which sets its actor tick interval, its movement components' tick interval
+ * and its pawn sensing interval. Skipped ticks are counted and turned into an estimate of the time saved.
+ */
+UCLASS(config = Game)
+class FPSGAME_API UFPSSignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UFPSSignificanceSubsystem();
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterActor(AActor* Actor);
+	void UnregisterActor(AActor* Actor);
+
+	void RegisterViewer(AActor* Viewer);
+	void UnregisterViewer(AActor* Viewer);
+
+	void LogStats() const;
+
+	// Sorted by MaxDistance. Actors beyond the last tier use the last tier
+	UPROPERTY(config)
+	TArray<FFPSSignificanceTier> Tiers;
+
+	UPROPERTY(config)
+	float UpdateInterval = 0.25f;
+
+	// Rough cost of one skipped actor or movement component tick, used for the time saved estimate
+	UPROPERTY(config)
+	float EstimatedActorTickMs = 0.005f;
+
+	UPROPERTY(config)
+	float EstimatedMovementTickMs = 0.03f;
+
+	double GetSkippedTickNum() const { return SkippedActorTicks + SkippedMovementTicks; }
+	double GetEstimatedMsSaved() const { return SkippedActorTicks * EstimatedActorTickMs + SkippedMovementTicks * EstimatedMovementTickMs; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FManagedActor
+	{
+		TWeakObjectPtr<AActor> Actor;
+		int32 Tier = 0;
+		// Settings the actor had when registered, used by the nearest tier and as a lower bound for the others
+		float BaseTickInterval = 0.0f;
+		float BaseMovementTickInterval = 0.0f;
+		float BaseSensingInterval = 0.0f;
+		// Effective intervals for the skipped tick count
+		float TickInterval = 0.0f;
+		float MovementTickInterval = 0.0f;
+		int32 MovementComponentNum = 0;
+	};
+
+	void UpdateTiers();
+	void ApplyTier(FManagedActor& Managed, int32 Tier);
+
+	TArray<FManagedActor> ManagedActors;
+	TArray<TWeakObjectPtr<AActor>> Viewers;
+	TArray<FVector> ViewerLocations;
+
+	float UpdateTimer = 0.0f;
+
+	double SkippedActorTicks = 0.0;
+	double SkippedMovementTicks = 0.0;
+};
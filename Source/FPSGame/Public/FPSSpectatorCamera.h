@@ -36,8 +36,6 @@ protected:
 	float LookSensitivity = 2.0f;
 
 public:	
-	virtual void Tick(float DeltaTime) override;
-
 	/** Handle movement input */
 	UFUNCTION(BlueprintCallable, Category = "Movement")
 	void MoveForward(float Value);
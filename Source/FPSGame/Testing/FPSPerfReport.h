@@ -0,0 +1,49 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+
+/**
+ * Shared settings and JSON output for the FPSGameTests.Perf.* suites.
+ * Settings live under [FPSGame.PerfTests] in DefaultGame.ini and can be overridden with -FPSPerf<Key>=<Value>.
+ */
+namespace FPSPerfReport
+{
+	inline float GetSetting(const TCHAR* Key, float DefaultValue)
+	{
+		float Value = DefaultValue;
+		GConfig->GetFloat(TEXT("FPSGame.PerfTests"), Key, Value, GGameIni);
+		FParse::Value(FCommandLine::Get(), *FString::Printf(TEXT("FPSPerf%s="), Key), Value);
+		return Value;
+	}
+
+	inline FString GetOutputDir()
+	{
+		FString Dir = FPaths::ProjectSavedDir() / TEXT("Automation") / TEXT("Perf");
+		FParse::Value(FCommandLine::Get(), TEXT("FPSPerfOutputDir="), Dir);
+		return Dir;
+	}
+
+	/** Serializes the report, writes it to the perf output directory and returns the JSON string */
+	inline FString Write(const TSharedRef<FJsonObject>& Report, const FString& FileName)
+	{
+		FString ReportString;
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ReportString);
+		FJsonSerializer::Serialize(Report, Writer);
+
+		FFileHelper::SaveStringToFile(ReportString, *(GetOutputDir() / FileName));
+		return ReportString;
+	}
+}
+
+#endif
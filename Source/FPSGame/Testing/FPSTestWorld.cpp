@@ -0,0 +1,57 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#include "FPSTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "UObject/UObjectGlobals.h"
+
+FFPSTestWorld::FFPSTestWorld(float FloorHalfExtent)
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("FPSTestWorld"));
+	check(World);
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	// Game mode is required for actors to receive BeginPlay
+	FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	// Flat floor so characters and ground traces behave as in a real arena
+	if (UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")))
+	{
+		AStaticMeshActor* Floor = Spawn<AStaticMeshActor>(FVector(0.0f, 0.0f, -50.0f));
+		if (Floor)
+		{
+			Floor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+			Floor->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+			Floor->SetActorScale3D(FVector(FloorHalfExtent / 50.0f, FloorHalfExtent / 50.0f, 1.0f));
+		}
+	}
+}
+
+FFPSTestWorld::~FFPSTestWorld()
+{
+	if (World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		World = nullptr;
+	}
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void FFPSTestWorld::Tick(float DeltaSeconds)
+{
+	World->Tick(LEVELTICK_All, DeltaSeconds);
+}
+
+#endif
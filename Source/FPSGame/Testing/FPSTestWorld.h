@@ -0,0 +1,44 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * Minimal game world built programmatically for automation tests and benchmarks.
+ * Creates a world context, a game mode and a floor, and tears everything down on destruction.
+ */
+class FFPSTestWorld
+{
+public:
+	explicit FFPSTestWorld(float FloorHalfExtent = 5000.0f);
+	~FFPSTestWorld();
+
+	UWorld* GetWorld() const { return World; }
+
+	/** Ticks the whole world once */
+	void Tick(float DeltaSeconds);
+
+	/** Spawns an actor and runs construction up to (but not including) BeginPlay, so properties can be set first */
+	template<typename T>
+	T* SpawnDeferred(UClass* Class, const FTransform& Transform)
+	{
+		return World->SpawnActorDeferred<T>(Class ? Class : T::StaticClass(), Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	}
+
+	template<typename T>
+	T* Spawn(const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		return World->SpawnActor<T>(T::StaticClass(), Location, Rotation, SpawnParams);
+	}
+
+private:
+	UWorld* World = nullptr;
+};
+
+#endif
@@ -0,0 +1,236 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "FPSTestWorld.h"
+#include "FPSPerfReport.h"
+#include "FPSCharacter.h"
+#include "FPSCharacterManagerComponent.h"
+#include "FPSCharacterInteractor.h"
+#include "FPSCharacterTrainingEnvironment.h"
+#include "FPSTargetActor.h"
+#include "LearningAgentsObservations.h"
+#include "LearningAgentsActions.h"
+#include "LearningAgentsCompletions.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformTime.h"
+
+namespace FPSMicroBenchmark
+{
+	/**
+	 * Reads the allocator's own Malloc/Realloc call counters, which FMalloc only exposes to derived classes.
+	 * They count calls from every thread and not every allocator maintains them, see AllocatorCountsCalls.
+	 */
+	struct FMallocCallCounter : public FMalloc
+	{
+		static uint64 GetAllocationCalls()
+		{
+			return TotalMallocCalls.load(std::memory_order_relaxed) + TotalReallocCalls.load(std::memory_order_relaxed);
+		}
+	};
+
+	/** Whether GMalloc updates the call counters at all, otherwise every count would read as zero */
+	bool AllocatorCountsCalls()
+	{
+		const uint64 Before = FMallocCallCounter::GetAllocationCalls();
+		void* Probe = FMemory::Malloc(64);
+		const uint64 After = FMallocCallCounter::GetAllocationCalls();
+		FMemory::Free(Probe);
+		return After != Before;
+	}
+
+	struct FResult
+	{
+		double Seconds = 0.0;
+		int64 Calls = 0;
+		int64 Allocations = 0;
+	};
+}
+
+// Times a single interactor or training environment callback in isolation over a large number of calls. The plural
+// (batched) interactor callbacks are called once per iteration for every agent and reported per agent as well.
+// Agents are stub AFPSCharacters registered straight with a UFPSCharacterManagerComponent - no manager actor,
+// policy or trainer process involved. Call count and agent count are -FPSPerfMicroCalls= and -FPSPerfMicroAgents=.
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FLearningMicroBenchmark, "FPSGameTests.Perf.Micro", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+void FLearningMicroBenchmark::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	const TCHAR* Callbacks[] = {
+		TEXT("GatherAgentObservation"),
+		TEXT("GatherAgentObservations"),
+		TEXT("PerformAgentAction"),
+		TEXT("PerformAgentActions"),
+		TEXT("GatherAgentReward"),
+		TEXT("GatherAgentCompletion"),
+		TEXT("ResetAgentEpisode")
+	};
+
+	for (const TCHAR* Callback : Callbacks)
+	{
+		OutBeautifiedNames.Add(Callback);
+		OutTestCommands.Add(Callback);
+	}
+}
+
+bool FLearningMicroBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace FPSMicroBenchmark;
+
+	const int32 AgentCount = FMath::Max(1, (int32)FPSPerfReport::GetSetting(TEXT("MicroAgents"), 32.0f));
+	const int64 TotalCalls = FMath::Max<int64>(AgentCount, (int64)FPSPerfReport::GetSetting(TEXT("MicroCalls"), 1000000.0f));
+	const int32 Iterations = (int32)FMath::Max<int64>(1, TotalCalls / AgentCount);
+
+	// Observation objects grow with every gather, so they are reset between batches outside the timed region
+	const int32 IterationsPerBatch = 64;
+
+	FFPSTestWorld TestWorld;
+
+	AFPSTargetActor* Target = TestWorld.Spawn<AFPSTargetActor>(FVector(0.0f, 0.0f, 50.0f));
+
+	AActor* Host = TestWorld.Spawn<AActor>(FVector::ZeroVector);
+	UFPSCharacterManagerComponent* ManagerComponent = NewObject<UFPSCharacterManagerComponent>(Host);
+	ManagerComponent->RegisterComponent();
+
+	if (AgentCount > ManagerComponent->GetMaxAgentNum())
+	{
+		AddError(FString::Printf(TEXT("Agent count %d exceeds MaxAgentNum %d"), AgentCount, ManagerComponent->GetMaxAgentNum()));
+		return false;
+	}
+
+	TArray<int32> AgentIds;
+	for (int32 AgentIndex = 0; AgentIndex < AgentCount; AgentIndex++)
+	{
+		const FVector Location(-1500.0f + (AgentIndex % 16) * 200.0f, -1500.0f + (AgentIndex / 16) * 200.0f, 120.0f);
+		AFPSCharacter* Character = TestWorld.Spawn<AFPSCharacter>(Location);
+		AgentIds.Add(ManagerComponent->AddAgent(Character));
+	}
+
+	UFPSCharacterInteractor* Interactor = Cast<UFPSCharacterInteractor>(ULearningAgentsInteractor::MakeInteractor(
+		ManagerComponent, UFPSCharacterInteractor::StaticClass(), TEXT("Benchmark Interactor")));
+	UFPSCharacterTrainingEnvironment* Environment = Cast<UFPSCharacterTrainingEnvironment>(ULearningAgentsTrainingEnvironment::MakeTrainingEnvironment(
+		ManagerComponent, UFPSCharacterTrainingEnvironment::StaticClass(), TEXT("Benchmark Training Environment")));
+
+	if (!Interactor || !Environment)
+	{
+		AddError(TEXT("Failed to create interactor or training environment"));
+		return false;
+	}
+	Interactor->TargetActor = Target;
+	Environment->TargetActor = Target;
+
+	// Prebuilt per-agent actions, read-only during the timed loop
+	ULearningAgentsActionObject* ActionObject = NewObject<ULearningAgentsActionObject>(Host);
+	TArray<FLearningAgentsActionObjectElement> ActionElements;
+	FRandomStream Random(1234);
+	for (int32 AgentIndex = 0; AgentIndex < AgentCount; AgentIndex++)
+	{
+		TMap<FName, FLearningAgentsActionObjectElement> Actions;
+		Actions.Add("MoveForward", ULearningAgentsActions::MakeFloatAction(ActionObject, Random.FRandRange(-1.0f, 1.0f)));
+		Actions.Add("MoveRight", ULearningAgentsActions::MakeFloatAction(ActionObject, Random.FRandRange(-1.0f, 1.0f)));
+		Actions.Add("Turn", ULearningAgentsActions::MakeFloatAction(ActionObject, Random.FRandRange(-1.0f, 1.0f)));
+		Actions.Add("LookUp", ULearningAgentsActions::MakeFloatAction(ActionObject, Random.FRandRange(-1.0f, 1.0f)));
+		ActionElements.Add(ULearningAgentsActions::MakeStructAction(ActionObject, Actions));
+	}
+
+	ULearningAgentsObservationObject* ObservationObject = NewObject<ULearningAgentsObservationObject>(Host);
+	TArray<FLearningAgentsObservationObjectElement> ObservationElements;
+	ObservationElements.Reserve(AgentCount);
+
+	// Put every agent in a valid episode before measuring
+	for (const int32 AgentId : AgentIds)
+	{
+		Environment->ResetAgentEpisode_Implementation(AgentId);
+	}
+
+	const bool bCountAllocations = AllocatorCountsCalls();
+	if (!bCountAllocations)
+	{
+		AddInfo(FString::Printf(TEXT("%s does not count allocation calls, allocations are not reported"), GMalloc->GetDescriptiveName()));
+	}
+
+	FResult Result;
+	for (int32 BatchStart = 0; BatchStart < Iterations; BatchStart += IterationsPerBatch)
+	{
+		const int32 BatchIterations = FMath::Min(IterationsPerBatch, Iterations - BatchStart);
+		ObservationObject->ObservationObject.Reset();
+
+		const uint64 StartAllocations = FMallocCallCounter::GetAllocationCalls();
+		const double Start = FPlatformTime::Seconds();
+
+		for (int32 Iteration = 0; Iteration < BatchIterations; Iteration++)
+		{
+			if (Parameters == TEXT("GatherAgentObservations"))
+			{
+				ObservationElements.Reset();
+				Interactor->GatherAgentObservations_Implementation(ObservationElements, ObservationObject, AgentIds);
+				continue;
+			}
+			if (Parameters == TEXT("PerformAgentActions"))
+			{
+				Interactor->PerformAgentActions_Implementation(ActionObject, ActionElements, AgentIds);
+				continue;
+			}
+
+			for (int32 AgentIndex = 0; AgentIndex < AgentCount; AgentIndex++)
+			{
+				const int32 AgentId = AgentIds[AgentIndex];
+
+				if (Parameters == TEXT("GatherAgentObservation"))
+				{
+					FLearningAgentsObservationObjectElement Element;
+					Interactor->GatherAgentObservation_Implementation(Element, ObservationObject, AgentId);
+				}
+				else if (Parameters == TEXT("PerformAgentAction"))
+				{
+					Interactor->PerformAgentAction_Implementation(ActionObject, ActionElements[AgentIndex], AgentId);
+				}
+				else if (Parameters == TEXT("GatherAgentReward"))
+				{
+					float Reward = 0.0f;
+					Environment->GatherAgentReward_Implementation(Reward, AgentId);
+				}
+				else if (Parameters == TEXT("GatherAgentCompletion"))
+				{
+					ELearningAgentsCompletion Completion = ELearningAgentsCompletion::Running;
+					Environment->GatherAgentCompletion_Implementation(Completion, AgentId);
+				}
+				else
+				{
+					Environment->ResetAgentEpisode_Implementation(AgentId);
+				}
+			}
+		}
+
+		Result.Seconds += FPlatformTime::Seconds() - Start;
+		Result.Allocations += (int64)(FMallocCallCounter::GetAllocationCalls() - StartAllocations);
+		Result.Calls += (int64)BatchIterations * AgentCount;
+	}
+
+	const double NsPerCall = Result.Calls > 0 ? (Result.Seconds * 1.0e9) / Result.Calls : 0.0;
+	const double AllocationsPerCall = Result.Calls > 0 ? (double)Result.Allocations / Result.Calls : 0.0;
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("test"), TEXT("Micro"));
+	Report->SetStringField(TEXT("callback"), Parameters);
+	Report->SetNumberField(TEXT("agents"), AgentCount);
+	Report->SetNumberField(TEXT("calls"), (double)Result.Calls);
+	Report->SetNumberField(TEXT("ns_per_agent_call"), NsPerCall);
+	if (bCountAllocations)
+	{
+		// Includes whatever other threads allocated meanwhile, so an upper bound for the callback itself
+		Report->SetNumberField(TEXT("allocations_per_call"), AllocationsPerCall);
+	}
+
+	AddInfo(FPSPerfReport::Write(Report, FString::Printf(TEXT("Micro_%s.json"), *Parameters)));
+
+	// Optional per-callback budgets, e.g. MaxNsPerCall_GatherAgentReward=2000
+	const float MaxNsPerCall = FPSPerfReport::GetSetting(*FString::Printf(TEXT("MaxNsPerCall_%s"), *Parameters), 0.0f);
+	if (MaxNsPerCall > 0.0f && NsPerCall > MaxNsPerCall)
+	{
+		AddError(FString::Printf(TEXT("%s: %.1f ns/agent/call exceeds budget of %.1f"), *Parameters, NsPerCall, MaxNsPerCall));
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif
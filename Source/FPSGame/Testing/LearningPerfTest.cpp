@@ -0,0 +1,212 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "FPSTestWorld.h"
+#include "FPSPerfReport.h"
+#include "FPSCharacter.h"
+#include "FPSCharacterManager.h"
+#include "FPSCharacterTrainingEnvironment.h"
+#include "FPSTargetActor.h"
+#include "LearningAgentsNeuralNetwork.h"
+#include "LearningAgentsPolicy.h"
+#include "LearningAgentsCompletions.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Serialization/JsonReader.h"
+
+namespace FPSPerfTest
+{
+	static double ToMs(double Seconds, int32 Steps)
+	{
+		return Steps > 0 ? (Seconds * 1000.0) / Steps : 0.0;
+	}
+}
+
+// Spawns 1/8/32/128 agents in a generated world and measures end-to-end learning step cost.
+// "Inference" runs the policy only, "Trainer" also gathers rewards/completions and resets
+// episodes every step the way the PPO trainer does, without the external trainer process.
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FLearningThroughputPerfTest, "FPSGameTests.Perf.Throughput", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+void FLearningThroughputPerfTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	const TCHAR* Modes[] = { TEXT("Inference"), TEXT("Trainer") };
+	const int32 AgentCounts[] = { 1, 8, 32, 128 };
+
+	for (const TCHAR* Mode : Modes)
+	{
+		for (const int32 AgentCount : AgentCounts)
+		{
+			OutBeautifiedNames.Add(FString::Printf(TEXT("%s.Agents%d"), Mode, AgentCount));
+			OutTestCommands.Add(FString::Printf(TEXT("%s %d"), Mode, AgentCount));
+		}
+	}
+}
+
+bool FLearningThroughputPerfTest::RunTest(const FString& Parameters)
+{
+	FString Mode;
+	FString AgentCountString;
+	if (!Parameters.Split(TEXT(" "), &Mode, &AgentCountString))
+	{
+		AddError(FString::Printf(TEXT("Invalid test parameters '%s'"), *Parameters));
+		return false;
+	}
+	const int32 AgentCount = FCString::Atoi(*AgentCountString);
+	const bool bTrainerMode = (Mode == TEXT("Trainer"));
+
+	const int32 WarmupSteps = (int32)FPSPerfReport::GetSetting(TEXT("WarmupSteps"), 30.0f);
+	const int32 Steps = (int32)FPSPerfReport::GetSetting(TEXT("Steps"), 300.0f);
+	const float DeltaTime = 1.0f / 60.0f;
+
+	const uint64 UsedPhysicalBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+	FFPSTestWorld TestWorld;
+
+	AFPSTargetActor* Target = TestWorld.Spawn<AFPSTargetActor>(FVector(0.0f, 0.0f, 50.0f));
+
+	// Lay agents out on a grid inside the default reset bounds
+	const int32 GridSize = FMath::CeilToInt(FMath::Sqrt((float)AgentCount));
+	for (int32 AgentIndex = 0; AgentIndex < AgentCount; AgentIndex++)
+	{
+		const FVector Location(
+			-1500.0f + 3000.0f * (AgentIndex % GridSize) / FMath::Max(GridSize - 1, 1),
+			-1500.0f + 3000.0f * (AgentIndex / GridSize) / FMath::Max(GridSize - 1, 1),
+			120.0f);
+		TestWorld.Spawn<AFPSCharacter>(Location);
+	}
+
+	// Networks are transient so the test doesn't depend on trained assets
+	AFPSCharacterManager* Manager = TestWorld.SpawnDeferred<AFPSCharacterManager>(nullptr, FTransform::Identity);
+	Manager->RunMode = EFPSCharacterManagerMode::Inference;
+	Manager->TargetActor = Target;
+	Manager->EncoderNeuralNetwork = NewObject<ULearningAgentsNeuralNetwork>(Manager);
+	Manager->PolicyNeuralNetwork = NewObject<ULearningAgentsNeuralNetwork>(Manager);
+	Manager->DecoderNeuralNetwork = NewObject<ULearningAgentsNeuralNetwork>(Manager);
+	Manager->CriticNeuralNetwork = NewObject<ULearningAgentsNeuralNetwork>(Manager);
+	Manager->FinishSpawning(FTransform::Identity);
+
+	// The test drives the learning step itself so each phase can be timed separately
+	Manager->SetActorTickEnabled(false);
+
+	ULearningAgentsPolicy* Policy = Manager->GetPolicy();
+	UFPSCharacterTrainingEnvironment* Environment = Manager->GetTrainingEnvironment();
+	const TArray<int32> AgentIds = Manager->GetManagedAgentIds();
+
+	if (!Policy || !Environment)
+	{
+		AddError(TEXT("Manager failed to create its policy or training environment"));
+		return false;
+	}
+	TestEqual(TEXT("Registered agent count"), AgentIds.Num(), AgentCount);
+
+	double InferenceSeconds = 0.0;
+	double EnvironmentSeconds = 0.0;
+	double WorldTickSeconds = 0.0;
+	int32 EpisodeResets = 0;
+
+	for (int32 Step = 0; Step < WarmupSteps + Steps; Step++)
+	{
+		const bool bMeasure = Step >= WarmupSteps;
+
+		const double InferenceStart = FPlatformTime::Seconds();
+		Policy->RunInference();
+		const double EnvironmentStart = FPlatformTime::Seconds();
+
+		if (bTrainerMode)
+		{
+			for (const int32 AgentId : AgentIds)
+			{
+				float Reward = 0.0f;
+				Environment->GatherAgentReward_Implementation(Reward, AgentId);
+
+				ELearningAgentsCompletion Completion = ELearningAgentsCompletion::Running;
+				Environment->GatherAgentCompletion_Implementation(Completion, AgentId);
+
+				if (Completion != ELearningAgentsCompletion::Running)
+				{
+					Environment->ResetAgentEpisode_Implementation(AgentId);
+					EpisodeResets += bMeasure ? 1 : 0;
+				}
+			}
+		}
+
+		const double WorldTickStart = FPlatformTime::Seconds();
+		TestWorld.Tick(DeltaTime);
+		const double StepEnd = FPlatformTime::Seconds();
+
+		if (bMeasure)
+		{
+			InferenceSeconds += EnvironmentStart - InferenceStart;
+			EnvironmentSeconds += WorldTickStart - EnvironmentStart;
+			WorldTickSeconds += StepEnd - WorldTickStart;
+		}
+	}
+
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+	const double TotalSeconds = InferenceSeconds + EnvironmentSeconds + WorldTickSeconds;
+	const double MsPerStep = FPSPerfTest::ToMs(TotalSeconds, Steps);
+	const double EnvStepsPerSecond = TotalSeconds > 0.0 ? ((double)AgentCount * Steps) / TotalSeconds : 0.0;
+
+	// Report
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("test"), TEXT("Throughput"));
+	Report->SetStringField(TEXT("mode"), Mode);
+	Report->SetNumberField(TEXT("agents"), AgentCount);
+	Report->SetNumberField(TEXT("steps"), Steps);
+	Report->SetNumberField(TEXT("env_steps_per_sec"), EnvStepsPerSecond);
+	Report->SetNumberField(TEXT("episode_resets"), EpisodeResets);
+
+	TSharedRef<FJsonObject> PhaseReport = MakeShared<FJsonObject>();
+	PhaseReport->SetNumberField(TEXT("inference"), FPSPerfTest::ToMs(InferenceSeconds, Steps));
+	PhaseReport->SetNumberField(TEXT("environment"), FPSPerfTest::ToMs(EnvironmentSeconds, Steps));
+	PhaseReport->SetNumberField(TEXT("world_tick"), FPSPerfTest::ToMs(WorldTickSeconds, Steps));
+	PhaseReport->SetNumberField(TEXT("total"), MsPerStep);
+	Report->SetObjectField(TEXT("ms_per_step"), PhaseReport);
+
+	Report->SetNumberField(TEXT("peak_used_physical_mb"), MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+	Report->SetNumberField(TEXT("used_physical_delta_mb"), ((double)MemoryStats.UsedPhysical - (double)UsedPhysicalBefore) / (1024.0 * 1024.0));
+
+	const FString BudgetKey = FString::Printf(TEXT("MaxMsPerStep_%s_%d"), *Mode, AgentCount);
+	const float BudgetScale = FPSPerfReport::GetSetting(TEXT("BudgetScale"), 1.0f);
+	const float MaxMsPerStep = FPSPerfReport::GetSetting(*BudgetKey, 0.0f) * BudgetScale;
+	Report->SetNumberField(TEXT("budget_ms_per_step"), MaxMsPerStep);
+
+	const FString ReportFileName = FString::Printf(TEXT("Throughput_%s_%d.json"), *Mode, AgentCount);
+	AddInfo(FPSPerfReport::Write(Report, ReportFileName));
+
+	// Absolute budget from config
+	if (MaxMsPerStep > 0.0f && MsPerStep > MaxMsPerStep)
+	{
+		AddError(FString::Printf(TEXT("%s: %.3f ms/step exceeds budget of %.3f ms/step"), *BudgetKey, MsPerStep, MaxMsPerStep));
+	}
+
+	// Relative budget against a previous run, e.g. -FPSPerfBaselineDir=PerfBaseline
+	FString BaselineDir;
+	if (FParse::Value(FCommandLine::Get(), TEXT("FPSPerfBaselineDir="), BaselineDir))
+	{
+		FString BaselineString;
+		TSharedPtr<FJsonObject> Baseline;
+		if (FFileHelper::LoadFileToString(BaselineString, *(BaselineDir / ReportFileName)) &&
+			FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineString), Baseline) && Baseline.IsValid())
+		{
+			const double BaselineStepsPerSecond = Baseline->GetNumberField(TEXT("env_steps_per_sec"));
+			const float MaxRegressionPercent = FPSPerfReport::GetSetting(TEXT("MaxRegressionPercent"), 15.0f);
+			const double MinStepsPerSecond = BaselineStepsPerSecond * (1.0 - MaxRegressionPercent / 100.0);
+
+			if (EnvStepsPerSecond < MinStepsPerSecond)
+			{
+				AddError(FString::Printf(TEXT("Throughput regressed: %.1f env-steps/sec vs baseline %.1f (allowed %.1f%%)"),
+					EnvStepsPerSecond, BaselineStepsPerSecond, MaxRegressionPercent));
+			}
+		}
+		else
+		{
+			AddWarning(FString::Printf(TEXT("No baseline found for %s in %s"), *ReportFileName, *BaselineDir));
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif
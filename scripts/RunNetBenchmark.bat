@@ -0,0 +1,28 @@
+:: Starts a local dedicated server with -FPSNetBenchmark and the given number of headless bot clients.
+:: The server writes Saved\NetBenchmark\NetBenchmark_<ReplicationDriver>_<Clients>.json and quits, and the bots quit with it.
+:: Pass -FPSNoRepGraph as extraServerArgs to measure the default replication for comparison.
+
+set ueLocation=%~1
+set projectLocation=%~2
+set projectName=%~3
+set mapName=%~4
+set clientCount=%~5
+set benchmarkSeconds=%~6
+set UnrealEditorCmd=%~7
+set extraServerArgs=%~8
+
+if "%clientCount%"=="" set clientCount=64
+if "%benchmarkSeconds%"=="" set benchmarkSeconds=60
+if "%UnrealEditorCmd%"=="" set UnrealEditorCmd=UnrealEditor-Cmd.exe
+
+set editorCmd="%ueLocation%\Engine\Binaries\Win64\%UnrealEditorCmd%"
+set project="%projectLocation%\%projectName%"
+
+start "FPSNetBenchmarkServer" %editorCmd% %project% %mapName% -server -log -nosound -NullRHI -unattended -FPSNetBenchmark=%benchmarkSeconds% -FPSNetBenchmarkClients=%clientCount% -Log=NetBenchmarkServer.log %extraServerArgs%
+
+:: Give the server time to load the map before the clients connect
+timeout /t 20 /nobreak > nul
+
+for /l %%i in (1,1,%clientCount%) do (
+	start "FPSBotClient%%i" /min %editorCmd% %project% 127.0.0.1 -game -nosound -NullRHI -unattended -FPSBotClient -Log=NetBenchmarkBot%%i.log
+)